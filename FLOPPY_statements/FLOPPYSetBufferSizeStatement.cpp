@@ -0,0 +1,8 @@
+#include "FLOPPYSetBufferSizeStatement.h"
+
+FLOPPYSetBufferSizeStatement::FLOPPYSetBufferSizeStatement() : 
+   FLOPPYStatement(SetBufferSizeStatement), nBlocks(0) {
+}
+
+FLOPPYSetBufferSizeStatement::~FLOPPYSetBufferSizeStatement() {
+}
@@ -0,0 +1,16 @@
+#ifndef __FLOPPY_SET_BUFFER_SIZE_STATEMENT_H__
+#define __FLOPPY_SET_BUFFER_SIZE_STATEMENT_H__
+
+#include "FLOPPYStatement.h"
+
+/**
+ * SET BUFFER SIZE <blocks>, grows or shrinks the buffer pool.
+ */
+class FLOPPYSetBufferSizeStatement : public FLOPPYStatement {
+   public:
+      FLOPPYSetBufferSizeStatement();
+      virtual ~FLOPPYSetBufferSizeStatement();
+
+      int nBlocks;
+}; 
+#endif /* __FLOPPY_SET_BUFFER_SIZE_STATEMENT_H__ */
@@ -0,0 +1,8 @@
+#include "FLOPPYShowBufferStatsStatement.h"
+
+FLOPPYShowBufferStatsStatement::FLOPPYShowBufferStatsStatement() : 
+   FLOPPYStatement(ShowBufferStatsStatement) {
+}
+
+FLOPPYShowBufferStatsStatement::~FLOPPYShowBufferStatsStatement() {
+}
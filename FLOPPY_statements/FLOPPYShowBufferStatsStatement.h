@@ -0,0 +1,14 @@
+#ifndef __FLOPPY_SHOW_BUFFER_STATS_STATEMENT_H__
+#define __FLOPPY_SHOW_BUFFER_STATS_STATEMENT_H__
+
+#include "FLOPPYStatement.h"
+
+/**
+ * SHOW BUFFER STATS, reports the buffer pool counters as a table.
+ */
+class FLOPPYShowBufferStatsStatement : public FLOPPYStatement {
+   public:
+      FLOPPYShowBufferStatsStatement();
+      virtual ~FLOPPYShowBufferStatsStatement();
+}; 
+#endif /* __FLOPPY_SHOW_BUFFER_STATS_STATEMENT_H__ */
@@ -12,7 +12,9 @@ typedef enum {
    InsertStatement,
    DeleteStatement,
    UpdateStatement,
-   SelectStatement 
+   SelectStatement,
+   ShowBufferStatsStatement,
+   SetBufferSizeStatement
 } StatementType;
 
 /**
@@ -9,6 +9,8 @@
 #include "FLOPPYDeleteStatement.h"
 #include "FLOPPYUpdateStatement.h"
 #include "FLOPPYSelectStatement.h"
+#include "FLOPPYShowBufferStatsStatement.h"
+#include "FLOPPYSetBufferSizeStatement.h"
 #include "FLOPPYSelectItem.h"
 #include "FLOPPYAggregate.h"
 #include "FLOPPYTableSpec.h"
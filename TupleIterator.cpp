@@ -208,15 +208,23 @@ char *Record::getBytes(RecordDesc desc) {
 }
 
 
-TupleIterator::TupleIterator(int fd) : fd(fd), _pageNdx(0) {
+TupleIterator::TupleIterator(int fd) : fd(fd), _pageNdx(0), guard(NULL) {
    heapHeaderGetNextPage(buffer, fd, &curPage);
    heapHeaderGetRecordDesc(buffer, fd, &recordDesc);
 
    heapHeaderGetRecordSize(buffer, fd, &recordSize);
    recordBytes = new char[recordSize];
 
-   pHGetMaxRecords(buffer, curPage, &recordsPerPage);
+   // same as the maxRecords every heap page is created with; reading it from
+   // curPage would touch page -1 when the table is empty
+   recordsPerPage = pageMaxRecords(recordSize);
    bitmap = new char[recordsPerPage / 8 + 1];
+   slots = new int[recordsPerPage];
+
+   int numBlocks;
+   heapHeaderGetNumBlocks(buffer, fd, &numBlocks);
+   ring = getScanRing(buffer, numBlocks);
+   adviseSequential(buffer, fd);
 
    startPage();
 }
@@ -224,22 +232,23 @@ TupleIterator::TupleIterator(int fd) : fd(fd), _pageNdx(0) {
 TupleIterator::~TupleIterator() {
    delete[] recordBytes;
    delete[] bitmap;
+   delete[] slots;
+   delete guard;
+   freeBufferRing(ring);
 }
 
 Record *TupleIterator::next() {
    if (curRecord == -1)
       return NULL;
 
-   getRecord(buffer, curPage, curRecord, recordBytes);
+   getRecord(buffer, curPage, curRecord, recordBytes, ring);
    Record *record = new Record(recordBytes, recordDesc, curPage, curRecord);
 
-   for (curRecord = curRecord + 1; curRecord < recordsPerPage; curRecord++) {
-      if (bitmapIsSet(bitmap, curRecord)) {
-         break;
-      }
+   if (++slot < numSlots) {
+      curRecord = slots[slot];
    }
-   if (curRecord == recordsPerPage) { // no more records on page
-      pHGetNextPage(buffer, curPage, &curPage);
+   else { // no more records on page
+      pHGetNextPage(buffer, curPage, &curPage, ring);
       startPage();
    }
 
@@ -255,21 +264,31 @@ void TupleIterator::goToPage(int page) {
 }
 
 void TupleIterator::startPage() {
-   if (curPage.pageId == -1) { // no more pages
-      curRecord = -1;
-      return;
-   }
+   while (1) {
+      delete guard;
+      guard = NULL;
 
-   _pageNdx++;
-   if (_pageNdx > pages.size())
-      pages.push_back(curPage);
+      if (curPage.pageId == -1) { // no more pages
+         curRecord = -1;
+         return;
+      }
 
-   pHGetBitmap(buffer, curPage, bitmap);
-   for (curRecord = 0; curRecord < recordsPerPage; curRecord++) {
-      if (bitmapIsSet(bitmap, curRecord)) {
+      _pageNdx++;
+      if (_pageNdx > pages.size())
+         pages.push_back(curPage);
+
+      // bring the page in through the ring so a big scan doesn't evict hot
+      // pages, and read it through the ring too so it isn't marked hot itself
+      guard = new PageGuard(buffer, curPage, ring);
+      pHGetBitmap(buffer, curPage, bitmap, ring);
+      numSlots = bitmapSelect(bitmap, recordsPerPage, slots);
+      if (numSlots > 0)
          break;
-      }
+
+      // deletes emptied the page, the scan goes on with the next one
+      pHGetNextPage(buffer, curPage, &curPage, ring);
    }
-   if (curRecord == recordsPerPage)
-      curRecord = -1;
+
+   slot = 0;
+   curRecord = slots[0];
 }
@@ -72,10 +72,15 @@ private:
    int recordsPerPage;
    RecordDesc recordDesc;
    char *bitmap;
+   int *slots; // the occupied slots of curPage, see bitmapSelect()
+   int numSlots;
+   int slot; // curRecord's index in slots
    char *recordBytes;
    vector<DiskAddress> pages;
    DiskAddress curPage;
+   BufferRing *ring; // NULL unless the table is big enough to flood the pool
    int _pageNdx;
+   PageGuard *guard; // keeps curPage pinned while its records are read
    int curRecord;
 };
 
@@ -0,0 +1,95 @@
+/**
+ * Measures the per-access cost of a buffer hit as the pool grows.
+ * For each pool size the pool is filled with pages of a scratch file, then
+ * resident pages are requested at random through readPage. The same lookups
+ * are also timed with a linear scan over the frames, which is what every
+ * buffer hit used to cost.
+ *
+ * To run:
+ *    make bufferBench
+ *    ./bufferBench [accesses]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+#include "bufferManager.h"
+
+#define BENCH_DISK "bench.dsk"
+#define BENCH_FILE "bench.dat"
+#define DEFAULT_ACCESSES 2000000
+#define SCAN_ACCESSES 20000
+
+static double now() {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* the old findPage: compare every frame's address */
+static int linearFind(Buffer *buf, DiskAddress diskPage) {
+   for (int i = 0; i < buf->nBufferBlocks; i++) {
+      if (buf->buffer_ref[i] != -1 && buf->frameAddr[i].FD == diskPage.FD
+       && buf->frameAddr[i].pageId == diskPage.pageId)
+         return i;
+   }
+   return -1;
+}
+
+int main(int argc, char **argv) {
+   int sizes[] = {500, 1000, 10000, 100000};
+   int accesses = argc > 1 ? atoi(argv[1]) : DEFAULT_ACCESSES;
+   long sink = 0;
+
+   printf("%10s %16s %16s\n", "frames", "hash ns/access", "scan ns/access");
+
+   for (unsigned s = 0; s < sizeof(sizes) / sizeof(int); s++) {
+      int n = sizes[s];
+      Buffer *buf = (Buffer *)malloc(sizeof(Buffer));
+      commence((char *)BENCH_DISK, buf, n, 1);
+
+      DiskAddress addr;
+      addr.FD = tfs_openFile((char *)BENCH_FILE);
+
+      /* fill the pool; pages past the end of the file read as zeros */
+      for (addr.pageId = 0; addr.pageId < n; addr.pageId++)
+         readPage(buf, addr);
+
+      /* a partition can overflow while others have room, so only ask for
+       * the pages that stayed resident */
+      std::vector<int> resident;
+      for (addr.pageId = 0; addr.pageId < n; addr.pageId++) {
+         if (findPage(buf, addr) != -1)
+            resident.push_back(addr.pageId);
+      }
+
+      std::vector<int> ids(accesses);
+      srand(s + 1);
+      for (int i = 0; i < accesses; i++)
+         ids[i] = resident[rand() % resident.size()];
+
+      double start = now();
+      for (int i = 0; i < accesses; i++) {
+         addr.pageId = ids[i];
+         sink += readPage(buf, addr);
+      }
+      double hashNs = (now() - start) / accesses;
+
+      int scans = accesses < SCAN_ACCESSES ? accesses : SCAN_ACCESSES;
+      start = now();
+      for (int i = 0; i < scans; i++) {
+         addr.pageId = ids[i];
+         sink += linearFind(buf, addr);
+      }
+      double scanNs = (now() - start) / scans;
+
+      printf("%10d %16.1f %16.1f\n", n, hashNs, scanNs);
+
+      deleteFile(buf, addr.FD);
+      squash(buf);
+   }
+
+   /* leave nothing behind in the directory it ran in */
+   remove(BENCH_DISK);
+   return sink == -1;
+}
@@ -5,87 +5,462 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <string.h>
-#include <time.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+/* packs a disk address into the key used by the page tables */
+static inline long long pageKey(DiskAddress diskPage) {
+   return ((long long)diskPage.FD << 32) | (unsigned int)diskPage.pageId;
+}
+
+/* returns the index stored for diskPage in the given table, or -1 if absent */
+static int lookupPage(PageTable *table, DiskAddress diskPage) {
+   PageTable::iterator it = table->find(pageKey(diskPage));
+   return it == table->end() ? -1 : it->second;
+}
+
+/* returns the partition diskPage lives in. A file's runs of PARTITION_RUN
+ * pages go round-robin over the partitions, starting at a spot picked by FD */
+static inline int partitionOf(Buffer *buf, DiskAddress diskPage) {
+   unsigned int start = (unsigned int)diskPage.FD * 0x9E3779B1u >> 16;
+   return (int)((start + (unsigned int)diskPage.pageId / PARTITION_RUN)
+    & (buf->nPartitions - 1));
+}
+
+/* returns the partition that owns frame num */
+static inline BufferPartition *framePartition(Buffer *buf, int num) {
+   return &buf->parts[num & (buf->nPartitions - 1)];
+}
+
+/* adds n to one of partition part's counters, for the pool and for file FD */
+static inline void countStat(BufferPartition *part, int FD,
+ long long BufferStats::*counter, int n = 1) {
+   part->stats.*counter += n;
+   part->fileStats[FD].*counter += n;
+}
+
+/* dirty pages taken out of their frames to be written back before the
+ * frames are read into, see evictFrame(). A miss evicts at most one frame
+ * for the page and one per page read ahead. */
+typedef struct {
+   int count;
+   DiskAddress addrs[READAHEAD_MAX + 1];
+   unsigned char *blocks[READAHEAD_MAX + 1];
+} WriteBacks;
+
+/* bytes of map's file that segment k maps, 0 if k isn't mapped */
+static size_t segmentBytes(FileMap *map, int k) {
+   size_t start = (size_t)k * MMAP_SEGMENT, end = (size_t)map->nPages * BLOCKSIZE;
+   if (!map->seg[k] || end <= start)
+      return 0;
+   return end - start < (size_t)MMAP_SEGMENT ? end - start : MMAP_SEGMENT;
+}
+
+/* unmaps every segment of map and frees it */
+static void unmapFile(FileMap *map) {
+   for (int k = 0; k < MMAP_SEGMENTS; k++) {
+      if (map->seg[k])
+         munmap(map->seg[k], MMAP_SEGMENT);
+   }
+   free(map);
+}
+
+static int writeRuns(Buffer *buf, DiskAddress *addrs, unsigned char **blocks, int count);
+static void addStats(BufferStats *to, const BufferStats &from);
+
+/*
+ * Each file's resident frames are threaded on a doubly-linked list through
+ * next and prev, with the head in heads, so a file's pages can be dropped
+ * without looking at every frame. linkFrame puts frame num on file FD's
+ * list, unlinkFrame takes it off.
+ */
+static void linkFrame(FileFrames *heads, int *next, int *prev, int FD, int num) {
+   FileFrames::iterator it = heads->find(FD);
+   prev[num] = -1;
+   if (it == heads->end()) {
+      next[num] = -1;
+      (*heads)[FD] = num;
+   }
+   else {
+      next[num] = it->second;
+      prev[it->second] = num;
+      it->second = num;
+   }
+}
+
+static void unlinkFrame(FileFrames *heads, int *next, int *prev, int FD, int num) {
+   if (prev[num] != -1)
+      next[prev[num]] = next[num];
+   else if (next[num] != -1)
+      (*heads)[FD] = next[num];
+   else
+      heads->erase(FD);
+   if (next[num] != -1)
+      prev[next[num]] = prev[num];
+}
+
+/* enters frame num, which now holds diskPage, in its partition's tables */
+static void mapFrame(Buffer *buf, int num, DiskAddress diskPage) {
+   BufferPartition *part = framePartition(buf, num);
+   part->pageTable[pageKey(diskPage)] = num;
+   linkFrame(&part->fileFrames, buf->fileNext, buf->filePrev, diskPage.FD, num);
+}
+
+/* takes frame num's page out of its partition's tables */
+static void unmapFrame(Buffer *buf, int num) {
+   BufferPartition *part = framePartition(buf, num);
+   part->pageTable.erase(pageKey(buf->frameAddr[num]));
+   unlinkFrame(&part->fileFrames, buf->fileNext, buf->filePrev,
+    buf->frameAddr[num].FD, num);
+}
+
+/* same as mapFrame and unmapFrame, for volatile slot num */
+static void mapCacheSlot(Buffer *buf, int num, DiskAddress diskPage) {
+   (*buf->cacheTable)[pageKey(diskPage)] = num;
+   linkFrame(buf->cacheFiles, buf->cacheNext, buf->cachePrev, diskPage.FD, num);
+}
+
+static void unmapCacheSlot(Buffer *buf, int num) {
+   buf->cacheTable->erase(pageKey(buf->cache[num].address));
+   unlinkFrame(buf->cacheFiles, buf->cacheNext, buf->cachePrev,
+    buf->cache[num].address.FD, num);
+}
+
+/*
+ * An empty frame is on no file's list, so its fileNext links it on its
+ * partition's free list instead. takeFreeFrame pops the first one of
+ * partition p, or returns -1 if there is none. freeFrame empties frame num,
+ * whose page must be out of the partition's tables already, and pushes it.
+ */
+static int takeFreeFrame(Buffer *buf, int p) {
+   BufferPartition *part = &buf->parts[p];
+   int num = part->freeFrames;
+   if (num != -1) {
+      part->freeFrames = buf->fileNext[num];
+      part->occupied++;
+   }
+   return num;
+}
+
+static void freeFrame(Buffer *buf, int num) {
+   BufferPartition *part = framePartition(buf, num);
+   buf->buffer_ref[num] = -1;
+   buf->pin[num] = 0;
+   buf->prefetched[num] = 0;
+   buf->dropped[num] = 0;
+   buf->fileNext[num] = part->freeFrames;
+   part->freeFrames = num;
+   part->occupied--;
+}
+
+/* drops a pin on frame num, freeing it if it was the last one on a frame
+ * deleteFile left behind */
+static void unpinFrame(Buffer *buf, int num) {
+   if (--buf->pin[num] == 0 && buf->dropped[num])
+      freeFrame(buf, num);
+}
+
+/* same as takeFreeFrame and freeFrame, for the volatile slots */
+static int takeFreeCacheSlot(Buffer *buf) {
+   int num = buf->cacheFree;
+   if (num != -1) {
+      buf->cacheFree = buf->cacheNext[num];
+      buf->numCacheOccupied++;
+   }
+   return num;
+}
+
+static void freeCacheSlot(Buffer *buf, int num) {
+   buf->cache_ref[num] = -1;
+   buf->cacheNext[num] = buf->cacheFree;
+   buf->cacheFree = num;
+   buf->numCacheOccupied--;
+}
+
+static void lockPartitions(Buffer *buf) {
+   for (int p = 0; p < buf->nPartitions; p++)
+      buf->parts[p].latch.lock();
+}
+
+static void unlockPartitions(Buffer *buf) {
+   for (int p = buf->nPartitions - 1; p >= 0; p--)
+      buf->parts[p].latch.unlock();
+}
+
+/* same as lockPartitions, and waits for each partition's reads and writes to
+ * finish first, so nothing is marked reading or writing once it returns */
+static void lockPartitionsIdle(Buffer *buf) {
+   for (int p = 0; p < buf->nPartitions; p++) {
+      std::unique_lock<std::mutex> lock(buf->parts[p].latch);
+      while (buf->parts[p].ioPending)
+         buf->parts[p].ioDone.wait(lock);
+      lock.release();
+   }
+}
+
+/*
+ * sets each partition's frame count and free list for a pool of
+ * buf->nBufferBlocks frames
+ */
+static void setPartitionFrames(Buffer *buf) {
+   int p, num;
+   for (p = 0; p < buf->nPartitions; p++) {
+      buf->parts[p].nFrames = (buf->nBufferBlocks - p + buf->nPartitions - 1) / buf->nPartitions;
+      if (buf->parts[p].hand >= buf->nBufferBlocks)
+         buf->parts[p].hand = p;
+      buf->parts[p].freeFrames = -1;
+   }
+   /* backwards, so that the lowest frames are handed out first */
+   for (num = buf->nBufferBlocks - 1; num >= 0; num--) {
+      if (buf->buffer_ref[num] == -1) {
+         BufferPartition *part = framePartition(buf, num);
+         buf->fileNext[num] = part->freeFrames;
+         part->freeFrames = num;
+      }
+   }
+}
+
+/*
+ * Maps the frame arena for nBlocks frames, aligned to ARENA_ALIGN. Stores
+ * the mapped length in *size. ARENA_HUGETLB falls back to transparent huge
+ * pages if the system has no huge pages reserved. Returns NULL on failure.
+ */
+static char *mapArena(int nBlocks, ArenaPages arenaPages, size_t *size) {
+   size_t len = ((size_t)nBlocks * BLOCKSIZE + ARENA_ALIGN - 1) & ~((size_t)ARENA_ALIGN - 1);
+   char *arena;
+
+   if (arenaPages == ARENA_HUGETLB) {
+      arena = (char *)mmap(NULL, len, PROT_READ | PROT_WRITE,
+       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (arena != MAP_FAILED) {
+         *size = len;
+         return arena;
+      }
+      perror("mapArena, MAP_HUGETLB");
+      arenaPages = ARENA_HUGE_PAGES;
+   }
+
+   /* over-map by ARENA_ALIGN and trim both ends to an aligned start */
+   arena = (char *)mmap(NULL, len + ARENA_ALIGN, PROT_READ | PROT_WRITE,
+    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+   if (arena == MAP_FAILED) {
+      perror("mapArena");
+      return NULL;
+   }
+   size_t head = (ARENA_ALIGN - (size_t)arena % ARENA_ALIGN) % ARENA_ALIGN;
+   if (head)
+      munmap(arena, head);
+   munmap(arena + head + len, ARENA_ALIGN - head);
+   arena += head;
+
+   if (arenaPages == ARENA_HUGE_PAGES)
+      madvise(arena, len, MADV_HUGEPAGE);
+   *size = len;
+   return arena;
+}
 
 /*
  * Mount FileSystem,
  * Initialize the buffer.
  */
 int commence(char * database,
-             Buffer * buf, 
-             int nBufferBlocks, 
+             Buffer * buf,
+             int nBufferBlocks,
              int nCacheBlocks) {
+   return commenceArena(database, buf, nBufferBlocks, nCacheBlocks,
+    nBufferBlocks, ARENA_HUGE_PAGES);
+}
+
+/*
+ * Same as commence, but the frames come from an arena backed by arenaPages
+ * and resizeBuffer can later grow the pool up to maxBufferBlocks frames.
+ * Frames only take memory once they are used.
+ */
+int commenceArena(char * database,
+                  Buffer * buf,
+                  int nBufferBlocks,
+                  int nCacheBlocks,
+                  int maxBufferBlocks,
+                  ArenaPages arenaPages) {
    int num, exit_code = 0;
 
+   if (maxBufferBlocks < nBufferBlocks)
+      maxBufferBlocks = nBufferBlocks;
+
    if (access(database, F_OK) == -1) { /* fs does not exist */
       exit_code += tfs_mkfs(database, (nBufferBlocks * sizeof(Block)) + sizeof(Buffer));
    }
-   /* mount the database */
-   exit_code += tfs_mount(database);
+   /* mount the database, which sets BLOCKSIZE for everything below */
+   if (tfs_mount(database) < 0)
+      return -1;
 
    /* initialize buffer */
-   buf->database = (char *)malloc(sizeof(strlen(database) * sizeof(char)));
+   buf->database = (char *)malloc(strlen(database) + 1);
    strcpy(buf->database, database);
 
    /* persistent slots */
    buf->nBufferBlocks = nBufferBlocks;
-   buf->numBufferOccupied = 0;
-   buf->pages = (Block *)malloc(sizeof(Block) * nBufferBlocks);
-   buf->buffer_timestamp = (long *)malloc(sizeof(long) * nBufferBlocks);
+   buf->maxBufferBlocks = maxBufferBlocks;
+   buf->pages = mapArena(maxBufferBlocks, arenaPages, &buf->arenaSize);
+   if (!buf->pages)
+      return -1;
+   buf->frameAddr = (DiskAddress *)malloc(sizeof(DiskAddress) * maxBufferBlocks);
+   buf->buffer_ref = (char *)malloc(sizeof(char) * maxBufferBlocks);
 
    /* volatile slots */
    buf->nCacheBlocks = nCacheBlocks;
    buf->numCacheOccupied = 0;
    buf->cache = (Block *)malloc(sizeof(Block) * nCacheBlocks);
-   buf->cache_timestamp = (long *)malloc(sizeof(long) * nCacheBlocks);
+   buf->cache_ref = (char *)malloc(sizeof(char) * nCacheBlocks);
+   buf->cacheHand = 0;
 
    /* other stuff */
-   buf->pin = (char *)malloc(sizeof(char) * nBufferBlocks);
-   buf->dirty = (char *)malloc(sizeof(char) * nBufferBlocks);
-   
-   for (num = 0; num < nBufferBlocks; num++) {
-      /* set timestamp to -1, -1 means it's an empty slot */
-      buf->buffer_timestamp[num] = -1;
+   buf->pin = (int *)malloc(sizeof(int) * maxBufferBlocks);
+   buf->uses = (int *)malloc(sizeof(int) * maxBufferBlocks);
+   buf->dirty = (char *)malloc(sizeof(char) * maxBufferBlocks);
+   buf->prefetched = (char *)malloc(sizeof(char) * maxBufferBlocks);
+   buf->writing = (char *)malloc(sizeof(char) * maxBufferBlocks);
+   buf->reading = (char *)malloc(sizeof(char) * maxBufferBlocks);
+   buf->dropped = (char *)malloc(sizeof(char) * maxBufferBlocks);
+   buf->fileNext = (int *)malloc(sizeof(int) * maxBufferBlocks);
+   buf->filePrev = (int *)malloc(sizeof(int) * maxBufferBlocks);
+   buf->cacheNext = (int *)malloc(sizeof(int) * nCacheBlocks);
+   buf->cachePrev = (int *)malloc(sizeof(int) * nCacheBlocks);
+   buf->frameLatch = (pthread_rwlock_t *)malloc(sizeof(pthread_rwlock_t) * maxBufferBlocks);
+
+   for (num = 0; num < maxBufferBlocks; num++) {
+      /* set reference bit to -1, -1 means it's an empty slot */
+      buf->buffer_ref[num] = -1;
       buf->pin[num] = 0;
+      buf->uses[num] = 0;
       buf->dirty[num] = 0;
+      buf->prefetched[num] = 0;
+      buf->writing[num] = 0;
+      buf->reading[num] = 0;
+      buf->dropped[num] = 0;
+      pthread_rwlock_init(&buf->frameLatch[num], NULL);
    }
 
-   for (num = 0; num < nCacheBlocks; num++) {
-      buf->cache_timestamp[num] = -1;
+   buf->cacheFree = -1;
+   for (num = nCacheBlocks - 1; num >= 0; num--) {
+      buf->cache[num].block = (char *)malloc(BLOCKSIZE);
+      buf->cache_ref[num] = -1;
+      buf->cacheNext[num] = buf->cacheFree;
+      buf->cacheFree = num;
    }
-   
+
+   buf->volatileFDs = NULL;
    buf->numVolatileFiles = 0;
+   buf->persistentFDs = NULL;
    buf->numPersistentFiles = 0;
-   
+
+   /* partitions, a power of two so that partitionOf can mask. Sized for the
+    * starting pool and kept across resizes. */
+   buf->nPartitions = 1;
+   while (buf->nPartitions * 2 <= BUFFER_PARTITIONS
+    && buf->nPartitions * 2 * PARTITION_MIN_FRAMES <= nBufferBlocks)
+      buf->nPartitions *= 2;
+   buf->parts = new BufferPartition[buf->nPartitions];
+   for (num = 0; num < buf->nPartitions; num++) {
+      buf->parts[num].hand = num;
+      buf->parts[num].occupied = 0;
+      buf->parts[num].ioPending = 0;
+      memset(&buf->parts[num].stats, 0, sizeof(BufferStats));
+   }
+   setPartitionFrames(buf);
+   for (num = 0; num < buf->nPartitions; num++)
+      buf->parts[num].pageTable.reserve(buf->parts[num].nFrames);
+
+   buf->cacheTable = new PageTable(nCacheBlocks);
+   buf->cacheFiles = new FileFrames;
+   buf->readAhead = new ReadAheadTable;
+   buf->memFiles = new std::unordered_map<int, int>;
+   buf->mmapMode = 0;
+   buf->fileMaps = new FileMapTable;
+   buf->mapLatch = (pthread_rwlock_t *)malloc(sizeof(pthread_rwlock_t) * MAP_LATCH_STRIPES);
+   for (num = 0; num < MAP_LATCH_STRIPES; num++)
+      pthread_rwlock_init(&buf->mapLatch[num], NULL);
+   buf->latch = new std::mutex;
+   buf->fileLatch = new std::mutex;
+   buf->bgWriter = NULL;
+   buf->pageIO = pageIOCreate(PAGEIO_URING);
+
+   buf->trace = NULL;
+   memset(&buf->hooks, 0, sizeof(FileHooks));
+   buf->warmRestart = 0;
+   buf->warmer = NULL;
+
    return exit_code;
 }
 
 int squash(Buffer * buf) {
    int num;
-   for (num = 0; num < buf->nBufferBlocks; num++) {
-      if (buf->pin[num] == 1) {
-         unPinPage(buf, buf->pages[num].address);
-      }
-      if (buf->dirty[num] == 1) {
-         flushPage(buf, buf->pages[num].address);
+   stopBgWriter(buf);
+   stopWarmer(buf);
+   for (num = 0; num < buf->nBufferBlocks; num++)
+      buf->pin[num] = 0;
+   int failed = flushAll(buf) < 0;
+   if (buf->warmRestart)
+      saveWarmPages(buf);
+   stopTrace(buf);
+   pageIODestroy(buf->pageIO);
+   for (num = 0; num < buf->maxBufferBlocks; num++)
+      pthread_rwlock_destroy(&buf->frameLatch[num]);
+   /* the memory-only tier goes away without being written anywhere */
+   for (num = 0; num < buf->nPartitions; num++) {
+      MemPageTable *memPages = &buf->parts[num].memPages;
+      for (MemPageTable::iterator it = memPages->begin(); it != memPages->end(); it++) {
+         pthread_rwlock_destroy(&it->second->latch);
+         free(it->second);
       }
    }
+   /* flushAll synced the mappings */
+   for (FileMapTable::iterator it = buf->fileMaps->begin(); it != buf->fileMaps->end(); it++)
+      unmapFile(it->second);
+   for (num = 0; num < MAP_LATCH_STRIPES; num++)
+      pthread_rwlock_destroy(&buf->mapLatch[num]);
 
    free(buf->database);
-   free(buf->pages);
+   munmap(buf->pages, buf->arenaSize);
+   free(buf->frameAddr);
+   for (num = 0; num < buf->nCacheBlocks; num++)
+      free(buf->cache[num].block);
    free(buf->cache);
-   free(buf->buffer_timestamp);
-   free(buf->cache_timestamp);
+   free(buf->buffer_ref);
+   free(buf->cache_ref);
    free(buf->pin);
    free(buf->dirty);
+   free(buf->prefetched);
+   free(buf->uses);
+   free(buf->writing);
+   free(buf->reading);
+   free(buf->dropped);
+   free(buf->fileNext);
+   free(buf->filePrev);
+   free(buf->cacheNext);
+   free(buf->cachePrev);
+   free(buf->frameLatch);
+   free(buf->mapLatch);
    free(buf->volatileFDs);
    free(buf->persistentFDs);
+   delete[] buf->parts;
+   delete buf->cacheTable;
+   delete buf->cacheFiles;
+   delete buf->readAhead;
+   delete buf->memFiles;
+   delete buf->fileMaps;
+   delete buf->latch;
+   delete buf->fileLatch;
    free(buf);
 
-   return tfs_unmount();
+   return failed ? -1 : tfs_unmount();
 }
 
-int checkPersistentFiles(Buffer *buf, int FD) {
+/* same as checkPersistentFiles, with fileLatch held */
+static int findPersistentFile(Buffer *buf, int FD) {
    for(int i = 0; i < buf->numPersistentFiles; i++) {
       if (buf->persistentFDs[i] == FD)
          return i;
@@ -93,7 +468,8 @@ int checkPersistentFiles(Buffer *buf, int FD) {
    return -1;
 }
 
-int checkVolatileFiles(Buffer *buf, int FD) {
+/* same as checkVolatileFiles, with fileLatch held */
+static int findVolatileFile(Buffer *buf, int FD) {
    for(int i = 0; i < buf->numVolatileFiles; i++) {
       if (buf->volatileFDs[i] == FD)
          return i;
@@ -101,289 +477,1190 @@ int checkVolatileFiles(Buffer *buf, int FD) {
    return -1;
 }
 
-/* returns the index of the first empty slot in buffer, or -1 if there isn't one. */
-int findEmpty(Buffer *buf) {
-   int i;
-   for (i = 0; i < buf->nBufferBlocks; i++) {
-      if (buf->buffer_timestamp[i] == -1) {
-         return i;
+int checkPersistentFiles(Buffer *buf, int FD) {
+   std::lock_guard<std::mutex> files(*buf->fileLatch);
+   return findPersistentFile(buf, FD);
+}
+
+int checkVolatileFiles(Buffer *buf, int FD) {
+   std::lock_guard<std::mutex> files(*buf->fileLatch);
+   return findVolatileFile(buf, FD);
+}
+
+/*
+ * CLOCK replacement: sweeps partition p's hand over its frames, giving every
+ * referenced frame a second chance by clearing its reference bit. Returns the
+ * first unpinned frame found with a clear bit, or -1 if every frame is pinned.
+ * Frames being written back are passed over like pinned ones.
+ * Each bit cleared was set by an earlier access, so a sweep is amortized O(1).
+ */
+static int clockSweep(Buffer *buf, int p) {
+   BufferPartition *part = &buf->parts[p];
+   int num, i;
+   /* after two full turns every unpinned frame has had its bit cleared */
+   for (i = 0; i < 2 * part->nFrames; i++) {
+      num = part->hand;
+      part->hand += buf->nPartitions;
+      if (part->hand >= buf->nBufferBlocks)
+         part->hand = p;
+
+      if (buf->pin[num] || buf->writing[num])
+         continue;
+      if (buf->buffer_ref[num] == 1) {
+         buf->buffer_ref[num] = 0;
+         continue;
       }
+      return num;
    }
    return -1;
 }
 
-/* returns the index in the buffer array */
-int readPage(Buffer * buf, DiskAddress diskPage) {
-   int num, available = 0, toEvict; /* available is set to 1 if there are any unpinned pages */
-   long oldest = -1;
-   /* check if this file has been opened before in persistent */
-   if (checkPersistentFiles(buf, diskPage.FD) == -1) {
-      buf->numPersistentFiles += 1;
-      buf->persistentFDs = (int *)realloc(buf->persistentFDs, sizeof(int) * buf->numPersistentFiles);
-      buf->persistentFDs[buf->numPersistentFiles-1] = diskPage.FD;
-   }
+/* same as clockSweep for the volatile slots, which are never pinned */
+static int cacheSweep(Buffer *buf) {
+   int num;
+   while (1) {
+      num = buf->cacheHand;
+      buf->cacheHand = (buf->cacheHand + 1) % buf->nCacheBlocks;
 
-   /* buffer check for page */
-   for (num = 0; num < buf->nBufferBlocks; num++) {
-      if (buf->buffer_timestamp[num] != -1 && buf->pages[num].address.FD == diskPage.FD && buf->pages[num].address.pageId == diskPage.pageId) { /* found page in buffer */
-         buf->buffer_timestamp[num] = time(NULL); 
+      if (buf->cache_ref[num] == 1)
+         buf->cache_ref[num] = 0;
+      else
          return num;
-      }
    }
+}
 
-   /* if this is reached, then the page is not in the buffer */
-   num = findEmpty(buf);
-   if (num != -1) {
-      /* bring page to buffer */
-      tfs_readPage(diskPage.FD, diskPage.pageId, 
-                  (unsigned char *)buf->pages[num].block);
-
-      /* sets page metadata */
-      buf->pages[num].address = diskPage; 
-      buf->buffer_timestamp[num] = time(NULL);         
-      
-      buf->numBufferOccupied++;
+/*
+ * Writes frame num back to disk. Its partition is latched through lock, which
+ * is let go for the write. The frame is marked writing meanwhile, so it is
+ * not evicted and no other write of it starts, and dirty is cleared first, so
+ * a change made during the write dirties it again. Returns -1, with the
+ * frame dirty again, if the write failed.
+ */
+static int flushFrame(Buffer *buf, std::unique_lock<std::mutex> &lock, int num) {
+   BufferPartition *part = framePartition(buf, num);
+   DiskAddress diskPage = buf->frameAddr[num];
+
+   buf->dirty[num] = 0;
+   buf->writing[num] = 1;
+   part->ioPending++;
+   countStat(part, diskPage.FD, &BufferStats::flushes);
+   lock.unlock();
+
+   int ret = tfs_writePage(diskPage.FD, diskPage.pageId, (unsigned char *) frameBlock(buf, num));
+
+   lock.lock();
+   buf->writing[num] = 0;
+   if (ret < 0 && !buf->dropped[num])
+      buf->dirty[num] = 1;
+   part->ioPending--;
+   part->ioDone.notify_all();
+   return ret;
+}
+
+/*
+ * Takes frame num's page out of the page table. A dirty page is put on wb to
+ * be written back before the frame is reused, and in its partition's
+ * evicting set until it has been, so that nobody reads it from disk before.
+ */
+static void evictFrame(Buffer *buf, int num, WriteBacks *wb) {
+   BufferPartition *part = framePartition(buf, num);
+   if (buf->dirty[num]) {
+      part->evicting.insert(pageKey(buf->frameAddr[num]));
+      wb->addrs[wb->count] = buf->frameAddr[num];
+      wb->blocks[wb->count++] = (unsigned char *)frameBlock(buf, num);
+      buf->dirty[num] = 0;
+      countStat(part, buf->frameAddr[num].FD, &BufferStats::flushes);
+      if (buf->bgWriter) /* the writer is falling behind */
+         buf->bgWriter->wake.notify_one();
+   }
+   unmapFrame(buf, num);
+   buf->prefetched[num] = 0;
+   countStat(part, buf->frameAddr[num].FD, &BufferStats::evictions);
+}
+
+/* points the pages on wb at copies of their frames, so that the frames can
+ * be reused before the pages are written back, see allocateCachePage() */
+static void copyWriteBacks(WriteBacks *wb) {
+   for (int i = 0; i < wb->count; i++) {
+      unsigned char *copy = (unsigned char *)malloc(BLOCKSIZE);
+      memcpy(copy, wb->blocks[i], BLOCKSIZE);
+      wb->blocks[i] = copy;
+   }
+}
+
+/*
+ * Finds a frame of partition p to load a new page into: an empty slot if
+ * there is one, otherwise a CLOCK victim, which is dropped from the page
+ * table and, if dirty, put on wb (see evictFrame). Returns -1 if every frame
+ * is pinned.
+ */
+static int getVictim(Buffer *buf, int p, WriteBacks *wb) {
+   int num = takeFreeFrame(buf, p);
+   if (num != -1)
       return num;
+
+   num = clockSweep(buf, p);
+   if (num == -1) /* all the pages are pinned */
+      return -1;
+
+   evictFrame(buf, num, wb);
+   return num;
+}
+
+/* sets the metadata of frame num, which now holds diskPage. A page loaded
+ * with its reference bit set counts as used once */
+static void setFrame(Buffer *buf, int num, DiskAddress diskPage, char ref) {
+   buf->frameAddr[num] = diskPage;
+   buf->buffer_ref[num] = ref;
+   buf->uses[num] = ref;
+   buf->dirty[num] = 0;
+   buf->prefetched[num] = 0;
+   mapFrame(buf, num, diskPage);
+}
+
+/* gives frame num to diskPage, which is about to be read into it. Until
+ * doneReading, the frame is pinned and marked reading, and whoever asks for
+ * diskPage waits for it (see readPageLocked) */
+static void startReading(Buffer *buf, int num, DiskAddress diskPage, char ref) {
+   setFrame(buf, num, diskPage, ref);
+   buf->reading[num] = 1;
+   buf->pin[num]++;
+}
+
+static void doneReading(Buffer *buf, int num) {
+   buf->reading[num] = 0;
+   unpinFrame(buf, num);
+}
+
+/*
+ * Undoes a load into count frames that failed, with their partition
+ * latched: the pages being read leave the frames. If restore is set the
+ * write-back of the victims on wb failed as well, before anything was read
+ * over them, and they go back in their frames still dirty. The other frames
+ * are freed.
+ */
+static void dropLoad(Buffer *buf, int *frames, int count, WriteBacks *wb, int restore) {
+   int i, j;
+   for (i = 0; i < count; i++) {
+      unmapFrame(buf, frames[i]);
+      for (j = 0; restore && j < wb->count; j++) {
+         if (wb->blocks[j] == (unsigned char *)frameBlock(buf, frames[i]))
+            break;
+      }
+      if (restore && j < wb->count) {
+         setFrame(buf, frames[i], wb->addrs[j], 0);
+         buf->dirty[frames[i]] = 1;
+      }
+      else if (buf->pin[frames[i]]) { /* freed by the last unpin */
+         buf->dropped[frames[i]] = 1;
+      }
+      else {
+         freeFrame(buf, frames[i]);
+      }
    }
-   
-   /* 
-    * Implement LRU eviction.
-    * all pageslots are full, check if they're all pinned 
-    */
-   for (num = 0; num < buf->nBufferBlocks; num++) {
-      if(buf->pin[num] == 0) { /* if the page is unpinned */
-         if (oldest == -1) { /* initial timestamp */
-            oldest = buf->buffer_timestamp[num];
-            toEvict = num;
-         }
-         else if (oldest > buf->buffer_timestamp[num]) { /* found an older time stamp */
-            oldest = buf->buffer_timestamp[num];
-            toEvict = num;
-         }
-         available = 1;
+}
+
+/*
+ * Finds a frame of partition p for page out of ring: the next of the ring's
+ * frames in p that still holds the page this ring put there, or failing that
+ * a frame from getVictim, which joins the ring in place of its oldest. Both
+ * go on wb if dirty. Returns -1 if every frame of p is pinned.
+ */
+static int ringFrame(Buffer *buf, int p, BufferRing *ring, DiskAddress page,
+ WriteBacks *wb) {
+   int num = -1, slot = ring->current, i;
+
+   for (i = 0; i < ring->size; i++) {
+      slot = (ring->current + i) % ring->size;
+      num = ring->frames[slot];
+      if (num != -1 && framePartition(buf, num) == &buf->parts[p]
+       && buf->buffer_ref[num] != -1 && !buf->pin[num] && !buf->writing[num]
+       && buf->frameAddr[num].FD == ring->pages[slot].FD
+       && buf->frameAddr[num].pageId == ring->pages[slot].pageId) {
+         evictFrame(buf, num, wb);
+         break;
       }
    }
-   if (available == 0) { /* all the pages are pinned */
-      return -1; /* error */
+   if (i == ring->size) {
+      slot = ring->current;
+      if ((num = getVictim(buf, p, wb)) == -1)
+         return -1;
    }
-   /* at this point a page needs to be evicted */
-   flushPage(buf, buf->pages[toEvict].address);
-   /* bring page to buffer */
-   tfs_readPage(diskPage.FD, diskPage.pageId, (unsigned char *)buf->pages[toEvict].block);
-   /* set other bits*/
-   buf->pages[toEvict].address = diskPage;
-   buf->buffer_timestamp[toEvict] = time(NULL); 
-   
-   return toEvict;
+   ring->current = (slot + 1) % ring->size;
+   ring->frames[slot] = num;
+   ring->pages[slot] = page;
+   return num;
 }
 
-/* If the given disk page is in the buffer, returns its index in
- * the buffer's array. Otherwise, returns -1. */
-int findPage(Buffer *buf, DiskAddress diskPage) {
-   int i;
-   for (i = 0; i < buf->nBufferBlocks; i++) {
-      if (buf->buffer_timestamp[i] == -1)
-         continue;
-      if (buf->pages[i].address.FD == diskPage.FD
-       && buf->pages[i].address.pageId == diskPage.pageId)
-         break;
+/*
+ * Called on every miss. Returns how many pages after diskPage to read ahead:
+ * 0 unless the miss continues an ascending run of pages on its file. The
+ * window doubles while at least half of the last batch got used and halves
+ * otherwise.
+ */
+static int readAheadWindow(Buffer *buf, DiskAddress diskPage, int nFrames) {
+   std::lock_guard<std::mutex> files(*buf->fileLatch);
+   ReadAheadTable::iterator it = buf->readAhead->find(diskPage.FD);
+   if (it == buf->readAhead->end()) {
+      ReadAhead fresh = {diskPage.pageId, READAHEAD_MIN, 0, 0};
+      (*buf->readAhead)[diskPage.FD] = fresh;
+      return 0;
+   }
+
+   ReadAhead &ra = it->second;
+   if (diskPage.pageId != ra.lastPage + 1) {
+      ra.lastPage = diskPage.pageId;
+      ra.window = READAHEAD_MIN;
+      ra.issued = ra.used = 0;
+      return 0;
+   }
+
+   if (ra.issued > 0) {
+      if (2 * ra.used >= ra.issued)
+         ra.window = ra.window * 2 > READAHEAD_MAX ? READAHEAD_MAX : ra.window * 2;
+      else
+         ra.window = ra.window / 2 < READAHEAD_MIN ? READAHEAD_MIN : ra.window / 2;
    }
-   if (i == buf->nBufferBlocks)
-      i = -1;
-   return i;
+   ra.lastPage = diskPage.pageId;
+
+   /* don't let read-ahead take over a small partition */
+   if (ra.window > nFrames / 4)
+      return nFrames / 4;
+   return ra.window;
 }
 
-/* If the given disk page is in the cache, returns its index in
- * the cache's array. Otherwise, returns -1. */
-int findPageVolatile(Buffer *buf, DiskAddress diskPage) {
-   int i;
-   for (i = 0; i < buf->nCacheBlocks; i++) {
-      if (buf->cache_timestamp[i] == -1)
-         continue;
-      if (buf->cache[i].address.FD == diskPage.FD
-       && buf->cache[i].address.pageId == diskPage.pageId)
+/*
+ * Reads diskPage from disk into frame num of partition p, which getVictim
+ * or ringFrame handed out. If the read continues a sequential run, the
+ * following pages of the file are read into frames of their own by the same
+ * call, as long as they belong to p. Read-ahead pages start with a clear
+ * reference bit so they go first if nobody wants them. With a ring they come
+ * out of the ring too, at most half of it at a time, so a scan keeps to its
+ * ring. diskPage itself starts with a clear bit then as well.
+ *
+ * p is latched through lock, which is let go for the I/O: the pages the
+ * victims held are written back from wb, then the new pages are read in.
+ * The new pages are in the page table from the start, marked reading, so
+ * others wait for them instead of reading them too. Returns -1, with the
+ * new pages gone again, if the I/O failed (see dropLoad).
+ */
+static int loadPage(Buffer *buf, std::unique_lock<std::mutex> &lock, int p, int num,
+ DiskAddress diskPage, BufferRing *ring, WriteBacks *wb) {
+   BufferPartition *part = &buf->parts[p];
+   int frames[READAHEAD_MAX + 1];
+   unsigned char *blocks[READAHEAD_MAX + 1];
+   int count, i, window = readAheadWindow(buf, diskPage, part->nFrames);
+   DiskAddress next = diskPage;
+
+   if (ring && window > ring->size / 2)
+      window = ring->size / 2;
+   int lastPage = window ? tfs_numPages(diskPage.FD) - 1 : diskPage.pageId;
+
+   frames[0] = num;
+   blocks[0] = (unsigned char *)frameBlock(buf, num);
+   startReading(buf, num, diskPage, ring ? 0 : 1);
+
+   /* stop at the end of the file, at the first page already resident or
+    * still being written back, or at the end of the partition's run */
+   for (count = 1; count <= window; count++) {
+      next.pageId = diskPage.pageId + count;
+      if (next.pageId > lastPage || partitionOf(buf, next) != p
+       || lookupPage(&part->pageTable, next) != -1
+       || (!part->evicting.empty() && part->evicting.count(pageKey(next))))
          break;
+      frames[count] = ring ? ringFrame(buf, p, ring, next, wb) : getVictim(buf, p, wb);
+      if (frames[count] == -1)
+         break;
+      startReading(buf, frames[count], next, 0);
+      buf->prefetched[frames[count]] = 1;
+      blocks[count] = (unsigned char *)frameBlock(buf, frames[count]);
    }
-   if (i == buf->nCacheBlocks)
-      i = -1;
-   return i;
-}
+   part->ioPending++;
+   lock.unlock();
 
-// Have readPage return the index of the page in the buffer after reading it in,
-// or -1 if error. This makes writePage really simple
-// writePage and flushPage return 0 for good, -1 for error?
-int writePage(Buffer *buf, DiskAddress diskPage) {
-   int i = readPage(buf, diskPage);
-   if (i < 0)
+   /* nothing is read over victims that didn't make it to disk */
+   int writeFailed = wb->count && writeRuns(buf, wb->addrs, wb->blocks, wb->count) < 0;
+   int readFailed = 0;
+   if (!writeFailed) {
+      PageIORequest req, *batch = &req;
+      pageIOPrepare(&req, PAGEIO_READ, diskPage.FD, diskPage.pageId, blocks, count);
+      readFailed = pageIORun(buf->pageIO, &batch, 1) < 0;
+   }
+
+   lock.lock();
+   for (i = 0; i < wb->count; i++)
+      part->evicting.erase(pageKey(wb->addrs[i]));
+   for (i = 0; i < count; i++)
+      doneReading(buf, frames[i]);
+   if (writeFailed || readFailed)
+      dropLoad(buf, frames, count, wb, writeFailed);
+   wb->count = 0;
+   part->ioPending--;
+   part->ioDone.notify_all();
+   if (writeFailed || readFailed)
       return -1;
 
-   buf->dirty[i] = 1;
-   buf->buffer_timestamp[i] = time(NULL);
+   if (count > 1)
+      countStat(part, diskPage.FD, &BufferStats::readAheads, count - 1);
 
+   if (window) {
+      std::lock_guard<std::mutex> files(*buf->fileLatch);
+      ReadAhead &ra = (*buf->readAhead)[diskPage.FD];
+      ra.issued = count - 1;
+      ra.used = 0;
+   }
    return 0;
 }
 
-int flushPage(Buffer *buf, DiskAddress diskPage) {
-   int i = findPage(buf, diskPage);
-   if (i < 0)
-      return -1;
-
-   tfs_writePage(diskPage.FD, diskPage.pageId, (unsigned char *) buf->pages[i].block);
-   buf->dirty[i] = 0;
+/* appends a request for page to the trace, if one is being taken */
+static void tracePage(Buffer *buf, DiskAddress page, int op) {
+   BufferTrace *t = buf->trace;
+   if (!t)
+      return;
 
-   return 0;
+   std::lock_guard<std::mutex> lock(t->lock);
+   TraceRecord *r = &t->records[t->count];
+   r->pageId = page.pageId;
+   r->FD = page.FD;
+   r->op = op;
+   r->pad = 0;
+   if (++t->count == TRACE_BATCH) {
+      fwrite(t->records, sizeof(TraceRecord), t->count, t->out);
+      t->count = 0;
+   }
 }
 
-// returns -1 if page not in buffer
-static int setPin(Buffer *buf, DiskAddress diskPage, int val) {
-   int i = findPage(buf, diskPage);
-   if (i < 0)
+/*
+ * Records every page request made of the pool from now on in the file at
+ * path, as an array of TraceRecords, for bufferSim to replay. Start and stop
+ * a trace while no pages are being requested. Returns -1 if a trace is
+ * already being taken or path can't be written.
+ */
+int startTrace(Buffer *buf, const char *path) {
+   if (buf->trace)
       return -1;
-   buf->pin[i] = val;
+   FILE *out = fopen(path, "wb");
+   if (!out)
+      return -1;
+
+   BufferTrace *t = new BufferTrace;
+   t->out = out;
+   t->count = 0;
+   buf->trace = t;
    return 0;
 }
 
-int pinPage(Buffer *buf, DiskAddress diskPage) {
-   return setPin(buf, diskPage, 1);
-}
+/* writes out what is left of the trace and closes it, if there is one */
+void stopTrace(Buffer *buf) {
+   BufferTrace *t = buf->trace;
+   if (!t)
+      return;
 
-int unPinPage(Buffer *buf, DiskAddress diskPage) {
-   return setPin(buf, diskPage, 0);
+   buf->trace = NULL;
+   fwrite(t->records, sizeof(TraceRecord), t->count, t->out);
+   fclose(t->out);
+   delete t;
 }
 
-int newPage(Buffer *buf, fileDescriptor FD, DiskAddress *diskPage) {
-   // if everything is pinned, return -1
-   int i;
-   for (i = 0; i < buf->nBufferBlocks; i++) {
-      if (!buf->pin[i])
-         break;
+/* adds FD to the persistent file list if it isn't there yet. Every resident
+ * page came in through a miss, so only misses need to check */
+static void notePersistentFile(Buffer *buf, int FD) {
+   std::lock_guard<std::mutex> files(*buf->fileLatch);
+   if (findPersistentFile(buf, FD) == -1) {
+      buf->numPersistentFiles += 1;
+      buf->persistentFDs = (int *)realloc(buf->persistentFDs, sizeof(int) * buf->numPersistentFiles);
+      buf->persistentFDs[buf->numPersistentFiles-1] = FD;
    }
-   if (i == buf->nBufferBlocks)
-      return -1;
+}
 
-   diskPage->FD = FD;
-   diskPage->pageId = tfs_numPages(FD);
-   char *data = (char *)calloc(BLOCKSIZE, 1);
-   tfs_writePage(FD, diskPage->pageId, (unsigned char *)data);
-   free(data);
+/*
+ * readPageRing for a page of partition p, with p latched through lock. A
+ * miss lets go of it while the page is read in, see loadPage.
+ */
+static int readPageLocked(Buffer *buf, std::unique_lock<std::mutex> &lock, int p,
+ DiskAddress diskPage, BufferRing *ring) {
+   BufferPartition *part = &buf->parts[p];
+   WriteBacks wb;
+   int num;
 
-   return readPage(buf, *diskPage);
-}
+   /* wait out a read of the page, or a write-back of it, that is still out */
+   while (1) {
+      num = lookupPage(&part->pageTable, diskPage);
+      if (num != -1 ? !buf->reading[num]
+       : part->evicting.empty() || !part->evicting.count(pageKey(diskPage)))
+         break;
+      part->ioDone.wait(lock);
+   }
 
-int allocateCachePage(Buffer *buf, DiskAddress diskpage){
-       int i, bufIndex, oldestCache = 0, oldestBuf = -1;
-       
-       /* check if this file has been opened before in volatile */
-   if (checkVolatileFiles(buf, diskpage.FD) == -1) {
-      buf->numVolatileFiles += 1;
-      buf->volatileFDs = (int *)realloc(buf->volatileFDs, sizeof(int) * buf->numVolatileFiles);
-      buf->volatileFDs[buf->numVolatileFiles-1] = diskpage.FD;
+   if (num != -1) { /* found page in buffer */
+      countStat(part, diskPage.FD, &BufferStats::hits);
+      if (!ring) {
+         buf->buffer_ref[num] = 1;
+         if (buf->uses[num] < INT_MAX)
+            buf->uses[num]++;
+      }
+      if (buf->prefetched[num]) { /* first use of a read-ahead page */
+         std::lock_guard<std::mutex> files(*buf->fileLatch);
+         ReadAhead &ra = (*buf->readAhead)[diskPage.FD];
+         ra.used++;
+         ra.lastPage = diskPage.pageId;
+         buf->prefetched[num] = 0;
+      }
+      return num;
    }
 
-   /* check if this page is already in cache */
-   i = findPageVolatile(buf, diskpage);
-   if (i != -1)
-      return i;
+   /* if this is reached, then the page is not in the buffer */
+   /* memory-only pages have no frame, they are reached through PageGuard */
+   if (!part->memPages.empty() && part->memPages.count(pageKey(diskPage)))
+      return -1;
 
-   /* check if this page is already in persistent buffer */
-   bufIndex = findPage(buf, diskpage);
-   
-       
-       //Check if cache is full
-       if(buf->nCacheBlocks == buf->numCacheOccupied){
-             
-             //Find index of least recently used for eviction
-             for(i = 0; i < buf->nCacheBlocks; i++){
-                  if(buf->cache_timestamp[oldestCache] > buf->cache_timestamp[i]) {
-                        oldestCache = i;
-                  }
-             }
-             buf->cache_timestamp[oldestCache] = -1;
-             
-             //Check if buffer is full
-             if(buf->nBufferBlocks == buf->numBufferOccupied){
-                  //If it is full find the least recently used unpinned page and write to disk
-                  for(i = 0; i < buf->nBufferBlocks; i++){
-                       if(buf->pin[i] == 0 &&
-                        (oldestBuf == -1 || buf->buffer_timestamp[oldestBuf] > buf->buffer_timestamp[i])) {
-                              oldestBuf = i;
-                       }
-                  }
-                  if (oldestBuf == -1) // all pages were pinned
-                     return -1;
-                  writePage(buf, buf->pages[oldestBuf].address);
-                  flushPage(buf, buf->pages[oldestBuf].address);
-             } else {
-                  //If it is not full then find empty spot and insert into buffer
-                  for(i = 0; i < buf->nBufferBlocks; i++){
-                        if(buf->buffer_timestamp[i] == -1){
-                              oldestBuf = i;
-                              buf->numBufferOccupied++;
-                              buf->buffer_timestamp[i] = time(NULL);
-                              break;
-                        }
-                  }
-             }
-             
-             //Copy the block from the cache into the buffer
-             memcpy(&(buf->pages[oldestBuf]), &(buf->cache[oldestCache]), sizeof(Block));
-             
-             
-             buf->pin[oldestBuf] = 1;
-       }
-       
-       //Write the diskapage passed into the now open cache spot
-       for(i = 0; i < buf->nCacheBlocks; i++){
-             if(buf->cache_timestamp[i] == -1){
-                   buf->cache[i].address.pageId = diskpage.pageId;
-                   buf->cache[i].address.FD = diskpage.FD;
-                   buf->numCacheOccupied++;
-                   buf->cache_timestamp[i] = time(NULL); 
-
-                   /* if page was already in persistent buffer, copy its data into this cache spot */
-                   if (bufIndex != -1) {
-                        memcpy(buf->cache[i].block, &buf->pages[bufIndex].block, BLOCKSIZE);
-
-                        /* remove page from persistent buffer */
-                        buf->buffer_timestamp[bufIndex] = -1;
-                        buf->pin[bufIndex] = 0;
-                        buf->numBufferOccupied--;
-                   }
-
-                   break;
-             }
-       }
-       return i;
- }
- 
-int removeCachePage(Buffer *buf, DiskAddress diskPage) {
-   int i;
-   for (i = 0; i < buf->nCacheBlocks; i++) {
-      Block temp = buf->cache[i];
-      if (temp.address.FD == diskPage.FD && temp.address.pageId == diskPage.pageId) {
-         buf->cache_timestamp[i] = -1;
-         buf->numCacheOccupied--;
-         return 0;
+   notePersistentFile(buf, diskPage.FD);
+   countStat(part, diskPage.FD, &BufferStats::misses);
+   wb.count = 0;
+   if (!ring) {
+      num = getVictim(buf, p, &wb);
+      if (num == -1) { /* error */
+         countStat(part, diskPage.FD, &BufferStats::allPinned);
+         return -1;
       }
+      return loadPage(buf, lock, p, num, diskPage, NULL, &wb) < 0 ? -1 : num;
    }
 
-   for (i = 0; i < buf->nBufferBlocks; i++) {
-      Block temp = buf->pages[i];
-      if (temp.address.FD == diskPage.FD && temp.address.pageId == diskPage.pageId) {
-         buf->buffer_timestamp[i] = -1;
-         buf->pin[i] = 0;
-         buf->numBufferOccupied--;
-         return 0;
-      }
+   num = ringFrame(buf, p, ring, diskPage, &wb);
+   if (num == -1) {
+      countStat(part, diskPage.FD, &BufferStats::allPinned);
+      return -1;
    }
+   return loadPage(buf, lock, p, num, diskPage, ring, &wb) < 0 ? -1 : num;
+}
 
-   return 1;
+/* returns the index in the buffer array */
+int readPage(Buffer * buf, DiskAddress diskPage) {
+   return readPageRing(buf, diskPage, NULL);
 }
 
-//int removeFileFromPersistentList(Buffer *buf, int fd) {
-//   int i;
-//
-//   i = checkPersistentFiles(buf,fd);
+/*
+ * Same as readPage, but on a miss the page is loaded into one of the ring's
+ * frames when the ring has one to recycle, so that a scan through ring never
+ * holds more than ring->size frames of the pool. Pages loaded through a ring
+ * start with a clear reference bit and are the first ones CLOCK evicts, and
+ * a hit through a ring leaves the bit as it is, so pass the ring to every
+ * read a scan makes of its pages. A NULL ring uses the shared pool normally.
+ * A ring belongs to one thread.
+ */
+int readPageRing(Buffer *buf, DiskAddress diskPage, BufferRing *ring) {
+   if (diskPage.pageId < 0 || buf->mmapMode) /* nothing goes in frames */
+      return -1;
+   tracePage(buf, diskPage, TRACE_READ);
+
+   int p = partitionOf(buf, diskPage);
+   std::unique_lock<std::mutex> lock(buf->parts[p].latch);
+   return readPageLocked(buf, lock, p, diskPage, ring);
+}
+
+/*
+ * Returns a ring for a sequential scan of a file with nPages pages, or NULL
+ * if the file is small enough to be scanned through the shared pool.
+ * Free it with freeBufferRing.
+ */
+BufferRing *getScanRing(Buffer *buf, int nPages) {
+   if (buf->mmapMode || nPages <= buf->nBufferBlocks / SCAN_RING_THRESHOLD)
+      return NULL;
+
+   BufferRing *ring = (BufferRing *)malloc(sizeof(BufferRing));
+   ring->size = buf->nBufferBlocks / SCAN_RING_THRESHOLD / 2;
+   if (ring->size > SCAN_RING_SIZE)
+      ring->size = SCAN_RING_SIZE;
+   if (ring->size < 1)
+      ring->size = 1;
+   ring->current = 0;
+   ring->frames = (int *)malloc(sizeof(int) * ring->size);
+   ring->pages = (DiskAddress *)malloc(sizeof(DiskAddress) * ring->size);
+   for (int i = 0; i < ring->size; i++)
+      ring->frames[i] = -1;
+
+   return ring;
+}
+
+void freeBufferRing(BufferRing *ring) {
+   if (!ring)
+      return;
+   free(ring->frames);
+   free(ring->pages);
+   free(ring);
+}
+
+/* If the given disk page is in the buffer, returns its index in
+ * the buffer's array. Otherwise, returns -1. */
+int findPage(Buffer *buf, DiskAddress diskPage) {
+   BufferPartition *part = &buf->parts[partitionOf(buf, diskPage)];
+   std::lock_guard<std::mutex> lock(part->latch);
+   return lookupPage(&part->pageTable, diskPage);
+}
+
+/* If the given disk page is in the cache, returns its index in
+ * the cache's array. Otherwise, returns -1. */
+int findPageVolatile(Buffer *buf, DiskAddress diskPage) {
+   std::lock_guard<std::mutex> lock(*buf->latch);
+   return lookupPage(buf->cacheTable, diskPage);
+}
+
+// Have readPage return the index of the page in the buffer after reading it in,
+// or -1 if error. This makes writePage really simple
+// writePage and flushPage return 0 for good, -1 for error?
+int writePage(Buffer *buf, DiskAddress diskPage) {
+   if (diskPage.pageId < 0)
+      return -1;
+   tracePage(buf, diskPage, TRACE_WRITE);
+
+   int p = partitionOf(buf, diskPage);
+   std::unique_lock<std::mutex> lock(buf->parts[p].latch);
+   int i = readPageLocked(buf, lock, p, diskPage, NULL);
+   if (i < 0)
+      return -1;
+
+   buf->dirty[i] = 1;
+
+   return 0;
+}
+
+/* msyncs the bytes of diskPage, for flushPage in mmap mode */
+static int syncMappedPage(Buffer *buf, DiskAddress diskPage) {
+   std::lock_guard<std::mutex> files(*buf->fileLatch);
+   FileMapTable::iterator it = buf->fileMaps->find(diskPage.FD);
+   size_t offset = (size_t)diskPage.pageId * BLOCKSIZE, k = offset / MMAP_SEGMENT;
+   /* a page never mapped had nothing written through a mapping */
+   if (it == buf->fileMaps->end() || k >= MMAP_SEGMENTS || !it->second->seg[k])
+      return 0;
+
+   size_t osPage = sysconf(_SC_PAGESIZE), at = offset % MMAP_SEGMENT;
+   char *start = it->second->seg[k] + at / osPage * osPage;
+   return msync(start, it->second->seg[k] + at + BLOCKSIZE - start, MS_SYNC) < 0 ? -1 : 0;
+}
+
+int flushPage(Buffer *buf, DiskAddress diskPage) {
+   if (buf->mmapMode && !isMemoryOnly(buf, diskPage.FD))
+      return syncMappedPage(buf, diskPage);
+
+   BufferPartition *part = &buf->parts[partitionOf(buf, diskPage)];
+   std::unique_lock<std::mutex> lock(part->latch);
+   int i;
+   /* one write of a page out at a time, and none of a page not read in yet */
+   while ((i = lookupPage(&part->pageTable, diskPage)) != -1
+    && (buf->reading[i] || buf->writing[i]))
+      part->ioDone.wait(lock);
+   if (i < 0)
+      return -1;
+
+   return flushFrame(buf, lock, i);
+}
+
+/*
+ * Writes blocks[i] to addrs[i] for count pages. The pages are sorted by
+ * (FD, pageId) and every run of consecutive pages on a file becomes one
+ * write of up to WRITE_RUN_MAX pages. The writes go to buf->pageIO in
+ * batches of PAGEIO_DEPTH, so that many are in flight together. Returns the
+ * number of writes issued, or -1 if any of them failed.
+ */
+static int writeRuns(Buffer *buf, DiskAddress *addrs, unsigned char **blocks, int count) {
+   std::vector<std::pair<long long, unsigned char *> > order(count);
+   std::vector<unsigned char *> run(count);
+   PageIORequest reqs[PAGEIO_DEPTH], *batch[PAGEIO_DEPTH];
+   int i, j, n, nReqs = 0, writes = 0, failed = 0;
+
+   for (i = 0; i < count; i++)
+      order[i] = std::make_pair(pageKey(addrs[i]), blocks[i]);
+   std::sort(order.begin(), order.end());
+
+   for (i = 0; i < count; i = j) {
+      run[i] = order[i].second;
+      for (j = i + 1, n = 1; j < count && n < WRITE_RUN_MAX
+       && order[j].first == order[j - 1].first + 1; j++, n++)
+         run[j] = order[j].second;
+      pageIOPrepare(&reqs[nReqs], PAGEIO_WRITE, (int)(order[i].first >> 32),
+       (unsigned int)order[i].first, &run[i], n);
+      batch[nReqs] = &reqs[nReqs];
+      writes++;
+      if (++nReqs == PAGEIO_DEPTH) {
+         if (pageIORun(buf->pageIO, batch, nReqs) < 0)
+            failed = 1;
+         nReqs = 0;
+      }
+   }
+   if (nReqs && pageIORun(buf->pageIO, batch, nReqs) < 0)
+      failed = 1;
+   return failed ? -1 : writes;
+}
+
+/*
+ * Writes back every dirty page in the buffer, coalesced into one write per
+ * run of consecutive pages (see writeRuns). Used by squash and as a
+ * checkpoint. Returns the number of writes issued, or -1 if any failed, in
+ * which case the pages are left dirty.
+ */
+int flushAll(Buffer *buf) {
+   std::vector<int> frames;
+   std::vector<DiskAddress> addrs;
+   std::vector<unsigned char *> blocks;
+   int num, writes = 0;
+
+   /* whatever the layer above holds back goes into its pages first */
+   if (buf->hooks.flush)
+      buf->hooks.flush(buf);
+
+   /* ordered after any older copy the background writer has out */
+   lockPartitionsIdle(buf);
+   for (num = 0; num < buf->nBufferBlocks; num++) {
+      if (buf->buffer_ref[num] != -1 && buf->dirty[num]) {
+         frames.push_back(num);
+         addrs.push_back(buf->frameAddr[num]);
+         blocks.push_back((unsigned char *)frameBlock(buf, num));
+         countStat(framePartition(buf, num), buf->frameAddr[num].FD, &BufferStats::flushes);
+         buf->dirty[num] = 0;
+         buf->writing[num] = 1;
+         framePartition(buf, num)->ioPending++;
+      }
+   }
+   unlockPartitions(buf);
+
+   /* same as flushFrame, for all of them at once */
+   if (!addrs.empty()) {
+      writes = writeRuns(buf, &addrs[0], &blocks[0], addrs.size());
+      lockPartitions(buf);
+      for (num = 0; num < (int)frames.size(); num++) {
+         buf->writing[frames[num]] = 0;
+         if (writes < 0 && !buf->dropped[frames[num]])
+            buf->dirty[frames[num]] = 1;
+         framePartition(buf, frames[num])->ioPending--;
+      }
+      for (num = 0; num < buf->nPartitions; num++)
+         buf->parts[num].ioDone.notify_all();
+      unlockPartitions(buf);
+   }
+
+   /* mapped files are written back by the kernel, make sure it has */
+   std::lock_guard<std::mutex> files(*buf->fileLatch);
+   for (FileMapTable::iterator it = buf->fileMaps->begin(); it != buf->fileMaps->end(); it++) {
+      for (int k = 0; k < MMAP_SEGMENTS; k++) {
+         size_t len = segmentBytes(it->second, k);
+         if (len && msync(it->second->seg[k], len, MS_SYNC) < 0)
+            writes = -1;
+      }
+   }
+   return writes;
+}
+
+/*
+ * Grows or shrinks the persistent pool to nBufferBlocks frames while it is
+ * in use. Shrinking writes back and drops the pages in the frames that go
+ * away and hands their memory back to the system. The whole pool is latched
+ * throughout, once the reads and writes out have finished. Returns -1 if
+ * nBufferBlocks is out of range, one of those frames is pinned or writing
+ * one back failed.
+ */
+int resizeBuffer(Buffer *buf, int nBufferBlocks) {
+   std::vector<DiskAddress> addrs;
+   std::vector<unsigned char *> blocks;
+   int num, dirtyTarget = -1;
+
+   if (nBufferBlocks < buf->nPartitions || nBufferBlocks > buf->maxBufferBlocks)
+      return -1;
+
+   /* the writer keeps frame numbers across a batch */
+   if (buf->bgWriter) {
+      dirtyTarget = buf->bgWriter->dirtyTarget;
+      stopBgWriter(buf);
+   }
+
+   std::lock_guard<std::mutex> lock(*buf->latch);
+   lockPartitionsIdle(buf);
+   for (num = nBufferBlocks; num < buf->nBufferBlocks; num++) {
+      if (buf->buffer_ref[num] != -1 && buf->pin[num])
+         break;
+   }
+   if (num < buf->nBufferBlocks) {
+      unlockPartitions(buf);
+      if (dirtyTarget != -1)
+         startBgWriter(buf, dirtyTarget);
+      return -1;
+   }
+
+   /* written back before anything is dropped, so a failed write loses
+    * nothing */
+   for (num = nBufferBlocks; num < buf->nBufferBlocks; num++) {
+      if (buf->buffer_ref[num] != -1 && buf->dirty[num]) {
+         addrs.push_back(buf->frameAddr[num]);
+         blocks.push_back((unsigned char *)frameBlock(buf, num));
+      }
+   }
+   if (!addrs.empty() && writeRuns(buf, &addrs[0], &blocks[0], addrs.size()) < 0) {
+      unlockPartitions(buf);
+      if (dirtyTarget != -1)
+         startBgWriter(buf, dirtyTarget);
+      return -1;
+   }
+
+   for (num = nBufferBlocks; num < buf->nBufferBlocks; num++) {
+      if (buf->buffer_ref[num] == -1)
+         continue;
+      if (buf->dirty[num])
+         countStat(framePartition(buf, num), buf->frameAddr[num].FD, &BufferStats::flushes);
+      countStat(framePartition(buf, num), buf->frameAddr[num].FD, &BufferStats::evictions);
+      unmapFrame(buf, num);
+      framePartition(buf, num)->occupied--;
+      buf->buffer_ref[num] = -1;
+      buf->dirty[num] = 0;
+      buf->prefetched[num] = 0;
+   }
+
+   if (nBufferBlocks < buf->nBufferBlocks) {
+      size_t keep = ((size_t)nBufferBlocks * BLOCKSIZE + ARENA_ALIGN - 1) & ~((size_t)ARENA_ALIGN - 1);
+      if (keep < buf->arenaSize)
+         madvise((char *)buf->pages + keep, buf->arenaSize - keep, MADV_DONTNEED);
+   }
+
+   buf->nBufferBlocks = nBufferBlocks;
+   setPartitionFrames(buf);
+   unlockPartitions(buf);
+
+   if (dirtyTarget != -1)
+      startBgWriter(buf, dirtyTarget);
+   return 0;
+}
+
+// Pins are counted: a page stays pinned until every pinPage has been matched
+// by an unPinPage. Both return -1 if the page is not in the buffer.
+int pinPage(Buffer *buf, DiskAddress diskPage) {
+   BufferPartition *part = &buf->parts[partitionOf(buf, diskPage)];
+   std::lock_guard<std::mutex> lock(part->latch);
+   int i = lookupPage(&part->pageTable, diskPage);
+   if (i < 0)
+      return -1;
+   buf->pin[i]++;
+   return 0;
+}
+
+int unPinPage(Buffer *buf, DiskAddress diskPage) {
+   BufferPartition *part = &buf->parts[partitionOf(buf, diskPage)];
+   std::lock_guard<std::mutex> lock(part->latch);
+   int i = lookupPage(&part->pageTable, diskPage);
+   if (i < 0)
+      return -1;
+   if (buf->pin[i] > 0)
+      unpinFrame(buf, i);
+   return 0;
+}
+
+/* the content latch mapped page shares with others */
+static pthread_rwlock_t *mapLatchOf(Buffer *buf, DiskAddress page) {
+   return &buf->mapLatch[pageKey(page) % MAP_LATCH_STRIPES];
+}
+
+/*
+ * Returns the mapping of page's file with a pin on it for the caller,
+ * mapping the segment page is in the first time, or NULL if page is past
+ * the end of the file or of the last segment, or the file is memory-only.
+ */
+static FileMap *mapPage(Buffer *buf, DiskAddress page) {
+   std::lock_guard<std::mutex> files(*buf->fileLatch);
+   FileMap *map;
+   FileMapTable::iterator it = buf->fileMaps->find(page.FD);
+   if (it != buf->fileMaps->end()) {
+      map = it->second;
+   }
+   else {
+      if (buf->memFiles->count(page.FD))
+         return NULL;
+      map = (FileMap *)calloc(1, sizeof(FileMap));
+      map->nPages = tfs_numPages(page.FD);
+      buf->fileMaps->insert(std::make_pair(page.FD, map));
+   }
+   if (page.pageId >= map->nPages)
+      return NULL;
+
+   size_t k = (size_t)page.pageId * BLOCKSIZE / MMAP_SEGMENT;
+   if (k >= MMAP_SEGMENTS)
+      return NULL;
+   if (!map->seg[k]) {
+      /* mapped past the end of the file, so that it can grow into the
+       * segment without moving it under anybody's guard */
+      void *seg = mmap(NULL, MMAP_SEGMENT, PROT_READ | PROT_WRITE,
+       MAP_SHARED | MAP_NORESERVE, page.FD, k * MMAP_SEGMENT);
+      if (seg == MAP_FAILED)
+         return NULL;
+      map->seg[k] = (char *)seg;
+   }
+   map->pin++;
+   return map;
+}
+
+/*
+ * Serves the table pages from mappings of their files rather than copies in
+ * the frames when on is set, which must happen before any page is read.
+ * The kernel then decides what stays resident and writes pages back;
+ * flushAll waits for it. Memory-only files are not mapped. Pages are reached
+ * through PageGuard only: readPage returns -1 in this mode.
+ */
+void setMmapMode(Buffer *buf, int on) {
+   buf->mmapMode = on;
+}
+
+/* tells the kernel file FD is about to be read start to end, in mmap mode */
+void adviseSequential(Buffer *buf, fileDescriptor FD) {
+   if (!buf->mmapMode)
+      return;
+   std::lock_guard<std::mutex> files(*buf->fileLatch);
+   FileMapTable::iterator it = buf->fileMaps->find(FD);
+   if (it == buf->fileMaps->end())
+      return;
+   for (int k = 0; k < MMAP_SEGMENTS; k++) {
+      size_t len = segmentBytes(it->second, k);
+      if (len)
+         madvise(it->second->seg[k], len, MADV_SEQUENTIAL);
+   }
+}
+
+PageGuard::PageGuard(Buffer *buf, DiskAddress page, BufferRing *ring,
+ PageLatch mode) : buf(buf), page(page), mode(LATCH_NONE) {
+   BufferPartition *part = &buf->parts[partitionOf(buf, page)];
+   frame = -1;
+   mem = NULL;
+   map = NULL;
+   if (page.pageId < 0)
+      return;
+   tracePage(buf, page, mode == LATCH_EXCLUSIVE ? TRACE_WRITE : TRACE_READ);
+
+   {
+      std::unique_lock<std::mutex> lock(part->latch);
+      if (!part->memPages.empty()) {
+         MemPageTable::iterator it = part->memPages.find(pageKey(page));
+         if (it != part->memPages.end()) {
+            mem = it->second;
+            mem->pin++;
+         }
+      }
+      if (!mem && !buf->mmapMode) {
+         frame = readPageLocked(buf, lock, part - buf->parts, page, ring);
+         if (frame >= 0)
+            buf->pin[frame]++;
+      }
+   }
+   if (!mem && buf->mmapMode)
+      map = mapPage(buf, page);
+
+   /* the pin keeps the frame ours while we wait for its contents */
+   latch(mode);
+}
+
+/* the content latch of the guard's page */
+pthread_rwlock_t *PageGuard::contentLatch() {
+   return mem ? &mem->latch : map ? mapLatchOf(buf, page) : &buf->frameLatch[frame];
+}
+
+/*
+ * Takes the page's content latch in mode on a guard that holds none, for
+ * callers that keep a page pinned for long but change it in short bursts.
+ * unlatch() gives it back and keeps the pin.
+ */
+void PageGuard::latch(PageLatch mode) {
+   if (!valid() || this->mode != LATCH_NONE || mode == LATCH_NONE)
+      return;
+   this->mode = mode;
+
+   pthread_rwlock_t *latch = contentLatch();
+   if ((mode == LATCH_SHARED ? pthread_rwlock_tryrdlock(latch)
+    : pthread_rwlock_trywrlock(latch)) == 0)
+      return;
+
+   {
+      BufferPartition *part = &buf->parts[partitionOf(buf, page)];
+      std::lock_guard<std::mutex> lock(part->latch);
+      countStat(part, page.FD, &BufferStats::pinWaits);
+   }
+   if (mode == LATCH_SHARED)
+      pthread_rwlock_rdlock(latch);
+   else
+      pthread_rwlock_wrlock(latch);
+}
+
+void PageGuard::unlatch() {
+   if (!valid() || mode == LATCH_NONE)
+      return;
+   pthread_rwlock_unlock(contentLatch());
+   mode = LATCH_NONE;
+}
+
+PageGuard::~PageGuard() {
+   unlatch();
+   if (mem) {
+      std::lock_guard<std::mutex> lock(buf->parts[partitionOf(buf, page)].latch);
+      if (--mem->pin == 0 && mem->dropped) {
+         pthread_rwlock_destroy(&mem->latch);
+         free(mem);
+      }
+      return;
+   }
+   if (map) {
+      std::lock_guard<std::mutex> files(*buf->fileLatch);
+      if (--map->pin == 0 && map->dropped)
+         unmapFile(map);
+      return;
+   }
+   if (frame < 0)
+      return;
+
+   std::lock_guard<std::mutex> lock(framePartition(buf, frame)->latch);
+   // the frame may have been invalidated under us by removeCachePage
+   if (buf->buffer_ref[frame] != -1 && buf->pin[frame] > 0
+    && buf->frameAddr[frame].FD == page.FD
+    && buf->frameAddr[frame].pageId == page.pageId)
+      unpinFrame(buf, frame);
+}
+
+bool PageGuard::valid() {
+   return frame >= 0 || mem || map;
+}
+
+char *PageGuard::data() {
+   if (map) {
+      size_t offset = (size_t)page.pageId * BLOCKSIZE;
+      return map->seg[offset / MMAP_SEGMENT] + offset % MMAP_SEGMENT;
+   }
+   return mem ? mem->block : frameBlock(buf, frame);
+}
+
+void PageGuard::markDirty() {
+   if (mem || map) /* never written back, or by the kernel */
+      return;
+   std::lock_guard<std::mutex> lock(framePartition(buf, frame)->latch);
+   if (!buf->dropped[frame]) /* its file is gone */
+      buf->dirty[frame] = 1;
+}
+
+/*
+ * Adds a zeroed page to the end of memory-only file diskPage->FD and sets
+ * diskPage->pageId to it. The file's page count goes up only once the page
+ * is in its partition's table, so deleteFile finds every page it counts.
+ */
+static int newMemPage(Buffer *buf, DiskAddress *diskPage) {
+   MemPage *mem = (MemPage *)calloc(1, sizeof(MemPage) + BLOCKSIZE);
+   if (!mem)
+      return -1;
+   mem->block = (char *)(mem + 1);
+   pthread_rwlock_init(&mem->latch, NULL);
+
+   for (;;) {
+      {
+         std::lock_guard<std::mutex> files(*buf->fileLatch);
+         std::unordered_map<int, int>::iterator it = buf->memFiles->find(diskPage->FD);
+         if (it == buf->memFiles->end())
+            break;
+         diskPage->pageId = it->second;
+      }
+      /* the partition latch comes before fileLatch */
+      BufferPartition *part = &buf->parts[partitionOf(buf, *diskPage)];
+      std::lock_guard<std::mutex> lock(part->latch);
+      std::lock_guard<std::mutex> files(*buf->fileLatch);
+      std::unordered_map<int, int>::iterator it = buf->memFiles->find(diskPage->FD);
+      if (it == buf->memFiles->end()) /* deleted meanwhile */
+         break;
+      if (it->second != diskPage->pageId) /* another newPage took it */
+         continue;
+      part->memPages[pageKey(*diskPage)] = mem;
+      it->second++;
+      return 0;
+   }
+   pthread_rwlock_destroy(&mem->latch);
+   free(mem);
+   return -1;
+}
+
+/*
+ * Keeps the pages of file FD, which must not have any yet, in memory only:
+ * newPage hands them out from the heap instead of the file, and they are
+ * never written back or evicted. They go away with deleteFile or squash.
+ * Their contents are reached through PageGuard; readPage returns -1 for
+ * them.
+ */
+int setMemoryOnly(Buffer *buf, fileDescriptor FD) {
+   std::lock_guard<std::mutex> files(*buf->fileLatch);
+   if (tfs_numPages(FD) > 0 || buf->memFiles->count(FD))
+      return -1;
+   buf->memFiles->insert(std::make_pair(FD, 0));
+   return 0;
+}
+
+/* returns 1 if file FD was passed to setMemoryOnly, 0 otherwise */
+int isMemoryOnly(Buffer *buf, fileDescriptor FD) {
+   std::lock_guard<std::mutex> files(*buf->fileLatch);
+   return buf->memFiles->count(FD) > 0;
+}
+
+int newPage(Buffer *buf, fileDescriptor FD, DiskAddress *diskPage) {
+   diskPage->FD = FD;
+   {
+      /* two sessions extending the same file must not get the same page */
+      std::unique_lock<std::mutex> files(*buf->fileLatch);
+      if (buf->memFiles->count(FD)) {
+         files.unlock();
+         return newMemPage(buf, diskPage);
+      }
+      diskPage->pageId = tfs_numPages(FD);
+      char *data = (char *)calloc(BLOCKSIZE, 1);
+      tfs_writePage(FD, diskPage->pageId, (unsigned char *)data);
+      free(data);
+
+      if (buf->mmapMode) {
+         /* the mapping already covers it, now that the file does too */
+         FileMapTable::iterator it = buf->fileMaps->find(FD);
+         if (it != buf->fileMaps->end())
+            it->second->nPages = diskPage->pageId + 1;
+         return 0;
+      }
+   }
+
+   // -1 if everything in the page's partition is pinned
+   return readPage(buf, *diskPage);
+}
+
+int allocateCachePage(Buffer *buf, DiskAddress diskpage){
+       int i, p, q, bufIndex, oldestCache = 0, oldestBuf = -1;
+   WriteBacks wb;
+   wb.count = 0;
+   std::unique_lock<std::mutex> lock(*buf->latch);
+
+       /* check if this file has been opened before in volatile */
+   {
+      std::lock_guard<std::mutex> files(*buf->fileLatch);
+      if (findVolatileFile(buf, diskpage.FD) == -1) {
+         buf->numVolatileFiles += 1;
+         buf->volatileFDs = (int *)realloc(buf->volatileFDs, sizeof(int) * buf->numVolatileFiles);
+         buf->volatileFDs[buf->numVolatileFiles-1] = diskpage.FD;
+      }
+   }
+
+   /* check if this page is already in cache */
+   i = lookupPage(buf->cacheTable, diskpage);
+   if (i != -1)
+      return i;
+
+   /* the partitions of this page and of the cache victim that moves to the
+    * persistent buffer */
+   p = q = partitionOf(buf, diskpage);
+   if(buf->nCacheBlocks == buf->numCacheOccupied){
+      oldestCache = cacheSweep(buf);
+      q = partitionOf(buf, buf->cache[oldestCache].address);
+   }
+   std::unique_lock<std::mutex> first(buf->parts[p < q ? p : q].latch);
+   std::unique_lock<std::mutex> second;
+   if (p != q)
+      second = std::unique_lock<std::mutex>(buf->parts[p < q ? q : p].latch);
+
+   /* check if this page is already in persistent buffer, and let any read
+    * or write of it that is out finish before it is moved */
+   std::unique_lock<std::mutex> &pageLock = p <= q ? first : second;
+   while ((bufIndex = lookupPage(&buf->parts[p].pageTable, diskpage)) != -1
+    && (buf->reading[bufIndex] || buf->writing[bufIndex]))
+      buf->parts[p].ioDone.wait(pageLock);
+
+
+       //Check if cache is full
+       if(buf->nCacheBlocks == buf->numCacheOccupied){
+
+             //The cache's CLOCK hand picked oldestCache above, find it a frame
+             //in its own partition: an empty one, or an unpinned victim that is
+             //written to disk first
+             if (bufIndex != -1) // keep the page we are about to copy
+                buf->pin[bufIndex]++;
+             oldestBuf = getVictim(buf, q, &wb);
+             if (bufIndex != -1)
+                buf->pin[bufIndex]--;
+             if (oldestBuf == -1) // all pages were pinned
+                return -1;
+             //The victim is written back from a copy once the latches are
+             //let go, its page stays in the evicting set until then
+             copyWriteBacks(&wb);
+             unmapCacheSlot(buf, oldestCache);
+
+             //Copy the block from the cache into the buffer
+             memcpy(frameBlock(buf, oldestBuf), buf->cache[oldestCache].block, BLOCKSIZE);
+             buf->frameAddr[oldestBuf] = buf->cache[oldestCache].address;
+             buf->buffer_ref[oldestBuf] = 1;
+             buf->uses[oldestBuf] = 1;
+             mapFrame(buf, oldestBuf, buf->frameAddr[oldestBuf]);
+             buf->prefetched[oldestBuf] = 0;
+             freeCacheSlot(buf, oldestCache);
+       }
+
+       //Write the diskapage passed into the now open cache spot
+       i = takeFreeCacheSlot(buf);
+       buf->cache[i].address.pageId = diskpage.pageId;
+       buf->cache[i].address.FD = diskpage.FD;
+       buf->cache_ref[i] = 1;
+       mapCacheSlot(buf, i, diskpage);
+
+       /* if page was already in persistent buffer, copy its data into this cache spot */
+       if (bufIndex != -1) {
+            memcpy(buf->cache[i].block, frameBlock(buf, bufIndex), BLOCKSIZE);
+
+            /* remove page from persistent buffer */
+            unmapFrame(buf, bufIndex);
+            freeFrame(buf, bufIndex);
+       }
+       if (!wb.count)
+          return i;
+
+       /* deleteFile waits for the write before it closes the file */
+       BufferPartition *part = &buf->parts[q];
+       part->ioPending++;
+       if (second.owns_lock())
+          second.unlock();
+       first.unlock();
+       lock.unlock();
+
+       /* the frame holds another page by now, so there is no putting the
+        * victim back */
+       if (writeRuns(buf, wb.addrs, wb.blocks, wb.count) < 0)
+          fprintf(stderr, "allocateCachePage: could not write back page %d of file %d\n",
+           wb.addrs[0].pageId, wb.addrs[0].FD);
+
+       std::lock_guard<std::mutex> partLock(part->latch);
+       for (int w = 0; w < wb.count; w++) {
+          part->evicting.erase(pageKey(wb.addrs[w]));
+          free(wb.blocks[w]);
+       }
+       part->ioPending--;
+       part->ioDone.notify_all();
+       return i;
+ }
+
+int removeCachePage(Buffer *buf, DiskAddress diskPage) {
+   std::lock_guard<std::mutex> lock(*buf->latch);
+   int i = lookupPage(buf->cacheTable, diskPage);
+   if (i != -1) {
+      unmapCacheSlot(buf, i);
+      freeCacheSlot(buf, i);
+      return 0;
+   }
+
+   BufferPartition *part = &buf->parts[partitionOf(buf, diskPage)];
+   std::unique_lock<std::mutex> partLock(part->latch);
+   while ((i = lookupPage(&part->pageTable, diskPage)) != -1
+    && (buf->reading[i] || buf->writing[i]))
+      part->ioDone.wait(partLock);
+   if (i != -1) {
+      unmapFrame(buf, i);
+      freeFrame(buf, i);
+      return 0;
+   }
+
+   return 1;
+}
+
+//int removeFileFromPersistentList(Buffer *buf, int fd) {
+//   int i;
+//
+//   i = checkPersistentFiles(buf,fd);
 //   if (i < 0)
 //      return -1;
 //
@@ -412,20 +1689,429 @@ int removeCachePage(Buffer *buf, DiskAddress diskPage) {
 //   return 0;
 //}
 
+/*
+ * Forgets everything the pool holds of file FD and deletes it. Frames that
+ * a PageGuard or a load still has pinned stay out of everyone's way until
+ * their last pin goes, and are never written back.
+ */
 void deleteFile(Buffer *buf, int FD) {
+   if (buf->hooks.drop)
+      buf->hooks.drop(buf, FD);
+
+   std::lock_guard<std::mutex> lock(*buf->latch);
+   /* don't close FD under a read or write that is out */
+   lockPartitionsIdle(buf);
    tfs_deleteFile(FD);
-   for (int i = 0; i < buf->nBufferBlocks; i++) {
-      if (buf->buffer_timestamp[i] != -1 && buf->pages[i].address.FD == FD) {
-         buf->buffer_timestamp[i] = -1;
-         buf->pin[i] = 0;
-         buf->numBufferOccupied--;
+   for (int p = 0; p < buf->nPartitions; p++) {
+      BufferPartition *part = &buf->parts[p];
+      FileFrames::iterator head = part->fileFrames.find(FD);
+      int next;
+      for (int i = head == part->fileFrames.end() ? -1 : head->second; i != -1;
+       i = next) {
+         next = buf->fileNext[i];
+         part->pageTable.erase(pageKey(buf->frameAddr[i]));
+         if (buf->pin[i]) { /* freed by the last unpin */
+            buf->dropped[i] = 1;
+            buf->dirty[i] = 0;
+            buf->prefetched[i] = 0;
+         }
+         else {
+            freeFrame(buf, i);
+         }
+      }
+      part->fileFrames.erase(FD);
+      FileStatsTable::iterator stats = part->fileStats.find(FD);
+      if (stats != part->fileStats.end()) {
+         BufferStats gone = stats->second;
+         part->fileStats.erase(stats);
+         addStats(&part->fileStats[DROPPED_FILES], gone);
+      }
+   }
+   {
+      std::lock_guard<std::mutex> files(*buf->fileLatch);
+      std::unordered_map<int, int>::iterator mem = buf->memFiles->find(FD);
+      if (mem != buf->memFiles->end()) {
+         DiskAddress page;
+         page.FD = FD;
+         for (page.pageId = 0; page.pageId < mem->second; page.pageId++) {
+            BufferPartition *part = &buf->parts[partitionOf(buf, page)];
+            MemPageTable::iterator it = part->memPages.find(pageKey(page));
+            if (it == part->memPages.end())
+               continue;
+            if (it->second->pin) { /* freed by the last guard */
+               it->second->dropped = 1;
+            }
+            else {
+               pthread_rwlock_destroy(&it->second->latch);
+               free(it->second);
+            }
+            part->memPages.erase(it);
+         }
+         buf->memFiles->erase(mem);
+      }
+      if (buf->warmer)
+         buf->warmer->files.erase(FD);
+      FileMapTable::iterator it = buf->fileMaps->find(FD);
+      if (it != buf->fileMaps->end()) {
+         if (it->second->pin) { /* unmapped by the last guard */
+            it->second->dropped = 1;
+         }
+         else {
+            unmapFile(it->second);
+         }
+         buf->fileMaps->erase(it);
       }
    }
+   unlockPartitions(buf);
+   {
+      std::lock_guard<std::mutex> files(*buf->fileLatch);
+      buf->readAhead->erase(FD);
+   }
+
+   FileFrames::iterator head = buf->cacheFiles->find(FD);
+   int next;
+   for (int i = head == buf->cacheFiles->end() ? -1 : head->second; i != -1;
+    i = next) {
+      next = buf->cacheNext[i];
+      buf->cacheTable->erase(pageKey(buf->cache[i].address));
+      freeCacheSlot(buf, i);
+   }
+   buf->cacheFiles->erase(FD);
+}
+
+/* adds the counters in from to those in to */
+static void addStats(BufferStats *to, const BufferStats &from) {
+   to->hits += from.hits;
+   to->misses += from.misses;
+   to->readAheads += from.readAheads;
+   to->evictions += from.evictions;
+   to->flushes += from.flushes;
+   to->bgWrites += from.bgWrites;
+   to->pinWaits += from.pinWaits;
+   to->allPinned += from.allPinned;
+}
+
+/*
+ * Fills in the counters for the whole pool in total and, if files is not
+ * NULL, for every file that has used the pool since it was opened, keyed by
+ * FD. resident and dirty are counted as of the call. deleteFile moves the
+ * counters of a file to DROPPED_FILES, so the files still add up to total.
+ */
+void getBufferStats(Buffer *buf, BufferStats *total, std::map<int, BufferStats> *files) {
+   memset(total, 0, sizeof(BufferStats));
+   if (files)
+      files->clear();
+
+   for (int p = 0; p < buf->nPartitions; p++) {
+      BufferPartition *part = &buf->parts[p];
+      std::lock_guard<std::mutex> lock(part->latch);
 
-   for (int i = 0; i < buf->nCacheBlocks; i++) {
-      if (buf->cache_timestamp[i] != -1 && buf->pages[i].address.FD == FD) {
-         buf->cache_timestamp[i] = -1;
-         buf->numCacheOccupied--;
+      addStats(total, part->stats);
+      if (files) {
+         for (FileStatsTable::iterator it = part->fileStats.begin();
+          it != part->fileStats.end(); it++) {
+            addStats(&(*files)[it->first], it->second);
+         }
+      }
+
+      for (int num = p; num < buf->nBufferBlocks; num += buf->nPartitions) {
+         if (buf->buffer_ref[num] == -1 || buf->dropped[num])
+            continue;
+         total->resident++;
+         total->dirty += buf->dirty[num];
+         if (files) {
+            BufferStats &file = (*files)[buf->frameAddr[num].FD];
+            file.resident++;
+            file.dirty += buf->dirty[num];
+         }
       }
    }
-}
\ No newline at end of file
+}
+
+/*
+ * One round of the background writer over partition p. Copies up to
+ * BGWRITER_BATCH dirty, unpinned pages out of the partition and writes the
+ * copies back with no latch held, so the foreground keeps the partition
+ * while the writes happen. Above the dirty target any dirty page is taken;
+ * below it only pages just ahead of the partition's CLOCK hand with a clear
+ * reference bit, which are the next victims. Returns the number of pages
+ * written.
+ */
+static int bgWriteBatch(Buffer *buf, int p, char *copies) {
+   BufferPartition *part = &buf->parts[p];
+   int frames[BGWRITER_BATCH];
+   DiskAddress addrs[BGWRITER_BATCH];
+   unsigned char *blocks[BGWRITER_BATCH];
+   int i, k, num, count = 0, nDirty = 0;
+   int n = part->nFrames, lookahead = n / 4, step = buf->nPartitions;
+
+   std::unique_lock<std::mutex> pool(part->latch);
+   int handNdx = part->hand / step;
+   int limit = buf->bgWriter->dirtyTarget * n / 100;
+   for (num = p; num < buf->nBufferBlocks; num += step)
+      nDirty += buf->buffer_ref[num] != -1 && buf->dirty[num];
+
+   for (k = 0; k < n && count < BGWRITER_BATCH; k++) {
+      num = p + ((handNdx + k) % n) * step;
+      if (buf->buffer_ref[num] == -1 || !buf->dirty[num] || buf->pin[num]
+       || buf->writing[num])
+         continue;
+      if (nDirty <= limit && (k >= lookahead || buf->buffer_ref[num] != 0))
+         continue;
+
+      /* a copy torn by a foreground write is fine: that write dirties the
+       * page again once it is done */
+      char *copy = copies + (size_t)count * BLOCKSIZE;
+      memcpy(copy, frameBlock(buf, num), BLOCKSIZE);
+      buf->dirty[num] = 0;
+      buf->writing[num] = 1;
+      frames[count] = num;
+      addrs[count] = buf->frameAddr[num];
+      blocks[count] = (unsigned char *)copy;
+      countStat(part, addrs[count].FD, &BufferStats::bgWrites);
+      count++;
+      nDirty--;
+   }
+   if (!count)
+      return 0;
+
+   part->ioPending++;
+   pool.unlock();
+   int failed = writeRuns(buf, addrs, blocks, count) < 0;
+
+   pool.lock();
+   for (i = 0; i < count; i++) {
+      buf->writing[frames[i]] = 0;
+      if (failed && !buf->dropped[frames[i]]) /* try again next round */
+         buf->dirty[frames[i]] = 1;
+   }
+   part->ioPending--;
+   part->ioDone.notify_all();
+   return count;
+}
+
+static void bgWriterLoop(Buffer *buf) {
+   BgWriter *w = buf->bgWriter;
+   char *copies;
+   /* aligned, so direct I/O can write the copies as they are */
+   if (posix_memalign((void **)&copies, TFS_DIRECT_ALIGN, BGWRITER_BATCH * BLOCKSIZE))
+      return;
+
+   while (1) {
+      {
+         std::unique_lock<std::mutex> lock(w->lock);
+         if (!w->stop)
+            w->wake.wait_for(lock, std::chrono::milliseconds(BGWRITER_DELAY_MS));
+         if (w->stop)
+            break;
+      }
+      for (int p = 0; p < buf->nPartitions; p++) {
+         while (bgWriteBatch(buf, p, copies) == BGWRITER_BATCH)
+            ;
+      }
+   }
+
+   free(copies);
+}
+
+/*
+ * Starts a thread that writes dirty pages back ahead of eviction, so that a
+ * miss rarely has to wait for its victim to be written. It keeps the share
+ * of dirty frames in each partition at or below dirtyTarget percent. Returns
+ * -1 if the writer is already running or dirtyTarget is out of range.
+ */
+int startBgWriter(Buffer *buf, int dirtyTarget) {
+   if (buf->bgWriter || dirtyTarget < 0 || dirtyTarget > 100)
+      return -1;
+
+   buf->bgWriter = new BgWriter;
+   buf->bgWriter->stop = false;
+   buf->bgWriter->dirtyTarget = dirtyTarget;
+   buf->bgWriter->thread = std::thread(bgWriterLoop, buf);
+   return 0;
+}
+
+/* stops the background writer, if there is one; dirty pages stay dirty */
+void stopBgWriter(Buffer *buf) {
+   BgWriter *w = buf->bgWriter;
+   if (!w)
+      return;
+
+   {
+      std::lock_guard<std::mutex> lock(w->lock);
+      w->stop = true;
+   }
+   w->wake.notify_one();
+   w->thread.join();
+   delete w;
+   buf->bgWriter = NULL;
+}
+
+/*
+ * Writes the pages resident in the persistent pool to database WARM_SUFFIX,
+ * one "file page heat" line each, heat being how many requests the page
+ * served while resident, for startWarmer to load after a restart.
+ * Returns the number of pages saved, or -1 if the file can't be written.
+ */
+int saveWarmPages(Buffer *buf) {
+   std::string path = std::string(buf->database) + WARM_SUFFIX;
+   FILE *out = fopen(path.c_str(), "w");
+   if (!out)
+      return -1;
+
+   int num, saved = 0;
+   lockPartitions(buf);
+   for (num = 0; num < buf->nBufferBlocks; num++) {
+      if (buf->buffer_ref[num] == -1 || buf->dropped[num])
+         continue;
+      std::string name = getFileName(buf->frameAddr[num].FD);
+      if (name.empty())
+         continue;
+      fprintf(out, "%s %d %d\n", name.c_str(), buf->frameAddr[num].pageId,
+       buf->uses[num]);
+      saved++;
+   }
+   unlockPartitions(buf);
+
+   fclose(out);
+   return saved;
+}
+
+static bool warmOrder(const WarmPage &a, const WarmPage &b) {
+   if (a.address.FD != b.address.FD)
+      return a.address.FD < b.address.FD;
+   return a.address.pageId < b.address.pageId;
+}
+
+static bool hotter(const WarmPage &a, const WarmPage &b) {
+   return a.heat > b.heat;
+}
+
+/*
+ * Loads pages[start] and the ones after it that continue the same run of
+ * partition p, with one read, into frames that are empty. A warm page never
+ * takes a frame that is in use. Returns how many pages it got through.
+ */
+static int warmRun(Buffer *buf, std::vector<WarmPage> &pages, int start) {
+   DiskAddress first = pages[start].address;
+   int p = partitionOf(buf, first);
+   BufferPartition *part = &buf->parts[p];
+   int frames[PAGEIO_MAX_PAGES];
+   unsigned char *blocks[PAGEIO_MAX_PAGES];
+   int count = 0, i;
+
+   std::unique_lock<std::mutex> lock(part->latch);
+   {
+      std::lock_guard<std::mutex> files(*buf->fileLatch);
+      if (!buf->warmer->files.count(first.FD)) /* deleted since */
+         return 1;
+   }
+   if (lookupPage(&part->pageTable, first) != -1)
+      return 1;
+
+   for (i = start; i < (int)pages.size() && count < PAGEIO_MAX_PAGES; i++) {
+      DiskAddress next = pages[i].address;
+      if (next.FD != first.FD || next.pageId != first.pageId + count
+       || partitionOf(buf, next) != p || lookupPage(&part->pageTable, next) != -1
+       || (!part->evicting.empty() && part->evicting.count(pageKey(next))))
+         break;
+      if ((frames[count] = takeFreeFrame(buf, p)) == -1)
+         break;
+      startReading(buf, frames[count], next, pages[i].heat > 0);
+      buf->uses[frames[count]] = pages[i].heat;
+      blocks[count] = (unsigned char *)frameBlock(buf, frames[count]);
+      count++;
+   }
+   if (!count) /* the partition is full already */
+      return 1;
+
+   notePersistentFile(buf, first.FD);
+   part->ioPending++;
+   lock.unlock();
+
+   PageIORequest req, *batch = &req;
+   pageIOPrepare(&req, PAGEIO_READ, first.FD, first.pageId, blocks, count);
+   int failed = pageIORun(buf->pageIO, &batch, 1) < 0;
+
+   lock.lock();
+   for (i = 0; i < count; i++)
+      doneReading(buf, frames[i]);
+   if (failed) {
+      WriteBacks none;
+      none.count = 0;
+      dropLoad(buf, frames, count, &none, 0);
+   }
+   part->ioPending--;
+   part->ioDone.notify_all();
+   return count;
+}
+
+static void warmerLoop(Buffer *buf) {
+   Warmer *w = buf->warmer;
+   int i = 0;
+   while (i < (int)w->pages.size() && !w->stop)
+      i += warmRun(buf, w->pages, i);
+}
+
+/*
+ * Turns on warm restart: squash will save the pool for the next run. Then
+ * reads the pages saveWarmPages left for the database and starts a thread
+ * that loads them back into empty frames in disk order, hottest pages first
+ * if not all of them fit. Pages of files that are gone or got shorter are
+ * skipped. Call it once the files are open and setMmapMode is settled; in
+ * mmap mode the frames hold no table pages, so it does nothing. Returns the
+ * number of pages to load, or -1 if there was no list.
+ */
+int startWarmer(Buffer *buf) {
+   if (buf->mmapMode || buf->warmer)
+      return -1;
+   buf->warmRestart = 1;
+
+   std::string path = std::string(buf->database) + WARM_SUFFIX;
+   FILE *in = fopen(path.c_str(), "r");
+   if (!in)
+      return -1;
+
+   Warmer *w = new Warmer;
+   std::map<std::string, int> fds; /* name -> FD, -1 if the file is gone */
+   char name[256];
+   int pageId, heat;
+   while (fscanf(in, "%255s %d %d", name, &pageId, &heat) == 3) {
+      std::map<std::string, int>::iterator it = fds.find(name);
+      if (it == fds.end()) {
+         int fd = access(name, F_OK) == 0 ? getFd(name) : -1;
+         it = fds.insert(std::make_pair(std::string(name), fd)).first;
+      }
+      if (it->second < 0 || pageId < 0 || pageId >= tfs_numPages(it->second))
+         continue;
+      WarmPage page = {{it->second, pageId}, heat};
+      w->pages.push_back(page);
+      w->files.insert(it->second);
+   }
+   fclose(in);
+   remove(path.c_str());
+
+   if ((int)w->pages.size() > buf->nBufferBlocks) {
+      std::stable_sort(w->pages.begin(), w->pages.end(), hotter);
+      w->pages.resize(buf->nBufferBlocks);
+   }
+   std::sort(w->pages.begin(), w->pages.end(), warmOrder);
+
+   int n = w->pages.size();
+   w->stop = false;
+   buf->warmer = w;
+   w->thread = std::thread(warmerLoop, buf);
+   return n;
+}
+
+/* stops loading warm pages, if that is still going on */
+void stopWarmer(Buffer *buf) {
+   Warmer *w = buf->warmer;
+   if (!w)
+      return;
+
+   w->stop = true;
+   w->thread.join();
+   delete w;
+   buf->warmer = NULL;
+}
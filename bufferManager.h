@@ -1,47 +1,346 @@
 #ifndef BUFFERMANAGER_H
 #define BUFFERMANAGER_H
 
+#include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <stdio.h>
+#include <pthread.h>
 #include "tinyFS.h"
 #include "libTinyFS.h"
+#include "pageIO.h"
 
 #define MAX_BUFFER_SIZE 5
 
+/* a scan gets a ring once its file is bigger than 1/SCAN_RING_THRESHOLD of
+ * the pool, and the ring holds at most SCAN_RING_SIZE frames */
+#define SCAN_RING_THRESHOLD 4
+#define SCAN_RING_SIZE 32
+
+/* bounds on how many pages a sequential miss reads ahead */
+#define READAHEAD_MIN 4
+#define READAHEAD_MAX 32
+
+/* the background writer wakes up every BGWRITER_DELAY_MS and writes back at
+ * most BGWRITER_BATCH pages per latch acquisition */
+#define BGWRITER_DELAY_MS 20
+#define BGWRITER_BATCH 16
+
+/* once startWarmer has been called, squash saves the resident pages of
+ * database to database WARM_SUFFIX for the next startWarmer to load again */
+#define WARM_SUFFIX ".warm"
+
+/* a trace buffers TRACE_BATCH records before writing them out */
+#define TRACE_BATCH 4096
+#define TRACE_READ 0
+#define TRACE_WRITE 1
+
+/* longest run of consecutive pages written in one request, at most
+ * PAGEIO_MAX_PAGES */
+#define WRITE_RUN_MAX 64
+
+/* the pool is split into up to BUFFER_PARTITIONS (a power of two) partitions
+ * of at least PARTITION_MIN_FRAMES frames. Runs of PARTITION_RUN consecutive pages of a
+ * file hash to the same partition, so read-ahead stays inside one. */
+#define BUFFER_PARTITIONS 16
+#define PARTITION_MIN_FRAMES 128
+#define PARTITION_RUN READAHEAD_MAX
+
+/* in mmap mode table files are mapped MMAP_SEGMENT bytes at a time, as
+ * they grow into each, up to MMAP_SEGMENTS of them, and mapped pages share
+ * MAP_LATCH_STRIPES content latches */
+#define MMAP_SEGMENT (1L << 30)
+#define MMAP_SEGMENTS 64
+#define MAP_LATCH_STRIPES 64
+
+/* the frame arena is aligned to a huge page so all of it can be backed by them */
+#define ARENA_ALIGN (2 << 20)
+
+/* what backs the frame arena, see commenceArena() */
+enum ArenaPages { ARENA_SMALL_PAGES, ARENA_HUGE_PAGES, ARENA_HUGETLB };
+
 typedef struct {
    fileDescriptor FD;
    int pageId;
 } DiskAddress;
 
+/* a volatile slot, block is BLOCKSIZE bytes of its own */
 typedef struct {
-   char block[BLOCKSIZE];
+   char *block;
    DiskAddress address;
 } Block;
 
+/* maps a packed (FD, pageId) key to a frame index, see pageKey() */
+typedef std::unordered_map<long long, int> PageTable;
+
+/*
+ * A page of a memory-only file, see setMemoryOnly(). It lives outside the
+ * frame arena and is never written back or evicted.
+ */
+typedef struct {
+   char *block; /* BLOCKSIZE bytes, allocated right after the MemPage */
+   pthread_rwlock_t latch; /* same as frameLatch for a frame */
+   int pin; /* PageGuards holding the page */
+   char dropped; /* the file is gone, the last guard frees the page */
+} MemPage;
+
+/* maps a packed (FD, pageId) key to a memory-only page */
+typedef std::unordered_map<long long, MemPage *> MemPageTable;
+
+/* a table file mapped in mmap mode, see setMmapMode() */
+typedef struct {
+   char *seg[MMAP_SEGMENTS]; /* segment k maps from byte k * MMAP_SEGMENT */
+   int nPages; /* pages of the file, the only ones that may be touched */
+   int pin; /* PageGuards on its pages */
+   char dropped; /* its file was deleted, the last guard unmaps it */
+} FileMap;
+
+typedef std::unordered_map<int, FileMap *> FileMapTable;
+
+/* sequential access detection for one file, see readAheadWindow() */
+typedef struct {
+   int lastPage; /* last page of the run read or used */
+   int window; /* pages to read ahead on the next sequential miss */
+   int issued; /* pages the last batch read ahead */
+   int used; /* how many of those have been hit since */
+} ReadAhead;
+
+typedef std::unordered_map<int, ReadAhead> ReadAheadTable;
+
+/* background writer state, see startBgWriter() */
+typedef struct {
+   std::thread thread;
+   std::mutex lock; /* guards stop */
+   std::condition_variable wake;
+   bool stop;
+   int dirtyTarget; /* percent of the frames allowed to stay dirty */
+} BgWriter;
+
+/* a page to load on a warm restart, heat is the use count it had */
+typedef struct {
+   DiskAddress address;
+   int heat;
+} WarmPage;
+
+/* warm restart prefetcher state, see startWarmer() */
 typedef struct {
+   std::thread thread;
+   std::atomic<bool> stop;
+   std::vector<WarmPage> pages; /* in disk order */
+   std::unordered_set<int> files; /* FDs still open, under fileLatch */
+} Warmer;
+
+/* one page request in a trace file, see startTrace() */
+typedef struct {
+   unsigned int pageId;
+   unsigned short FD;
+   unsigned char op; /* TRACE_READ or TRACE_WRITE */
+   unsigned char pad;
+} TraceRecord;
+
+typedef struct {
+   std::mutex lock; /* guards everything below */
+   FILE *out;
+   TraceRecord records[TRACE_BATCH];
+   int count;
+} BufferTrace;
+
+/* buffer pool counters, for the whole pool or for one file, see getBufferStats() */
+typedef struct {
+   long long hits;
+   long long misses;
+   long long readAheads; /* pages read ahead of a sequential miss */
+   long long evictions;
+   long long flushes; /* pages written back by the foreground */
+   long long bgWrites; /* pages written back by the background writer */
+   long long pinWaits; /* PageGuards that waited for another's content latch */
+   long long allPinned; /* misses that failed because every frame was pinned */
+   int resident; /* frames holding a page right now */
+   int dirty;
+} BufferStats;
+
+/* the FD deleteFile moves a file's counters to, so that the per-file counters
+ * still add up to the pool's */
+#define DROPPED_FILES -1
+
+typedef std::unordered_map<int, BufferStats> FileStatsTable;
+
+/* FD -> first frame of the file's list, see linkFrame() */
+typedef std::unordered_map<int, int> FileFrames;
+
+/*
+ * One hash partition of the persistent pool, see partitionOf(). Partition p
+ * owns frames p, p + nPartitions, p + 2 * nPartitions, ... and runs CLOCK
+ * over them on its own.
+ */
+typedef struct {
+   std::mutex latch; /* guards pageTable, hand, occupied, freeFrames and the
+                      * partition's entries in the Buffer's per-frame arrays */
+   PageTable pageTable; /* resident pages of this partition -> frame index */
+   int hand; /* next frame the CLOCK hand inspects */
+   int nFrames;
+   int occupied;
+   int freeFrames; /* first empty frame, the rest follow through fileNext */
+   BufferStats stats;
+   FileStatsTable fileStats; /* FD -> the share of stats for that file */
+   FileFrames fileFrames; /* FD -> the file's frames in this partition */
+   MemPageTable memPages; /* memory-only pages that hash to this partition */
+   int ioPending; /* reads and write-backs out with the latch let go */
+   std::condition_variable ioDone; /* notified, under latch, as each ends */
+   std::unordered_set<long long> evicting; /* keys of pages evicted dirty
+                                            * and not written back yet */
+} BufferPartition;
+
+struct Buffer;
+
+/*
+ * Lets the layer above keep state of its own per file in step with the pool,
+ * see openHeapFiles(). flush is run first thing in flushAll, drop when a file
+ * is deleted. Neither is called with any latch of the pool held.
+ */
+typedef struct {
+   void *state;
+   void (*flush)(struct Buffer *buf);
+   void (*drop)(struct Buffer *buf, fileDescriptor FD);
+} FileHooks;
+
+/*
+ * Latch order: latch, then partition latches in ascending order, then
+ * fileLatch. Frame content latches are never taken while holding any of
+ * these. No latch of the pool is held across disk I/O: the frames involved
+ * are marked reading or writing instead, see loadPage() and flushFrame().
+ */
+typedef struct Buffer {
    char *database;
    int nBufferBlocks;
+   int maxBufferBlocks; /* the per-frame arrays are this long */
    int nCacheBlocks;
-   Block * pages;
+   char * pages; /* the frame arena, see frameBlock() */
+   DiskAddress * frameAddr; /* page held by each frame */
+   size_t arenaSize;
    Block * cache;
-   long * buffer_timestamp;
-   long * cache_timestamp;
-   char * pin;
+   char * buffer_ref; /* CLOCK reference bits, -1 marks an empty slot */
+   int * uses; /* requests the frame's page served since it came in, the
+                * heat saveWarmPages keeps for it */
+   char * cache_ref;
+   int cacheHand;
+   int * pin; /* pin count per frame, pinned frames are never evicted */
    char * dirty;
-   int numBufferOccupied;
+   char * prefetched; /* read ahead and not used yet */
+   char * writing; /* page is being written back, see flushFrame() */
+   char * reading; /* page is being read in, see loadPage() */
+   char * dropped; /* its file was deleted while the frame was pinned, the
+                    * last unpin frees it, see deleteFile() */
+   int * fileNext; /* per frame, the next and previous frame of the same */
+   int * filePrev; /* file in the same partition, -1 at the ends */
+   int * cacheNext; /* same for the volatile slots */
+   int * cachePrev;
+   int cacheFree; /* first empty volatile slot, the rest follow through
+                   * cacheNext */
    int numCacheOccupied;
    int *volatileFDs;
    int numVolatileFiles;
    int *persistentFDs;
    int numPersistentFiles;
+   int nPartitions;
+   BufferPartition *parts;
+   pthread_rwlock_t *frameLatch; /* page contents, taken by PageGuard */
+   PageTable *cacheTable; /* resident volatile pages -> index in cache */
+   FileFrames *cacheFiles; /* FD -> the file's volatile slots */
+   ReadAheadTable *readAhead; /* FD -> read-ahead state */
+   std::unordered_map<int, int> *memFiles; /* memory-only FD -> its page count */
+   int mmapMode; /* serve table pages from file mappings, not frames */
+   FileMapTable *fileMaps; /* FD -> its mapping, in mmap mode */
+   pthread_rwlock_t *mapLatch; /* content latches of mapped pages */
+   std::mutex *latch; /* guards the volatile slots */
+   std::mutex *fileLatch; /* guards the file lists, readAhead, memFiles and
+                           * fileMaps */
+   BgWriter *bgWriter; /* NULL unless startBgWriter was called */
+   int warmRestart; /* squash saves the pool, set by startWarmer */
+   Warmer *warmer; /* NULL unless startWarmer found pages to load */
+   BufferTrace *trace; /* NULL unless startTrace was called */
+   PageIO *pageIO; /* where reads and write-backs are submitted */
+   FileHooks hooks; /* all NULL unless the layer above set them */
 } Buffer;
 
+/* the page in frame num. Frames sit BLOCKSIZE apart in the arena, and the
+ * page each holds is kept apart in frameAddr, so they start at multiples of
+ * BLOCKSIZE, as direct I/O needs */
+static inline char *frameBlock(Buffer *buf, int num) {
+   return buf->pages + (size_t)num * BLOCKSIZE;
+}
+
+/* a private ring of frames that a sequential scan recycles, see readPageRing */
+typedef struct {
+   int size;
+   int current; /* next slot to recycle */
+   int *frames; /* frame index of each slot, -1 if unused */
+   DiskAddress *pages; /* page each slot's frame was loaded with */
+} BufferRing;
+
+/* what a PageGuard holds on the page's contents besides the pin */
+enum PageLatch { LATCH_NONE, LATCH_SHARED, LATCH_EXCLUSIVE };
+
+/*
+ * Pins a persistent page for as long as the guard lives, so data() stays a
+ * stable pointer into the page's frame. Call markDirty() after changing the
+ * page through data(). Check valid() first: it is false if the page could
+ * not be brought into the buffer.
+ *
+ * With LATCH_SHARED or LATCH_EXCLUSIVE the guard also holds the frame's
+ * content latch, so other threads see the page either before or after the
+ * change. Don't latch a page the same thread already holds exclusively.
+ */
+class PageGuard {
+public:
+   PageGuard(Buffer *buf, DiskAddress page, BufferRing *ring = NULL,
+    PageLatch mode = LATCH_NONE);
+   ~PageGuard();
+
+   bool valid();
+   char *data();
+   void markDirty();
+   void latch(PageLatch mode);
+   void unlatch();
+
+private:
+   PageGuard(const PageGuard &) = delete;
+   PageGuard &operator=(const PageGuard &) = delete;
+
+   pthread_rwlock_t *contentLatch();
+
+   Buffer *buf;
+   DiskAddress page;
+   int frame;
+   MemPage *mem; /* set instead of frame for a memory-only page */
+   FileMap *map; /* set instead of frame for a page in mmap mode */
+   PageLatch mode;
+};
+
 int commence(char *database, Buffer *buf, int nBufferBlocks, int nCacheBlocks);
+int commenceArena(char *database, Buffer *buf, int nBufferBlocks, int nCacheBlocks,
+                  int maxBufferBlocks, ArenaPages arenaPages);
+int resizeBuffer(Buffer *buf, int nBufferBlocks);
 int squash(Buffer *buf);
 int readPage(Buffer *buf, DiskAddress diskPage);
+int readPageRing(Buffer *buf, DiskAddress diskPage, BufferRing *ring);
+BufferRing *getScanRing(Buffer *buf, int nPages);
+void freeBufferRing(BufferRing *ring);
 int writePage(Buffer *buf, DiskAddress diskPage);
 int flushPage(Buffer *buf, DiskAddress diskPage);
+int flushAll(Buffer *buf);
 int pinPage(Buffer *buf, DiskAddress diskPage);
 int unPinPage(Buffer *buf, DiskAddress diskPage);
 int newPage(Buffer *buf, fileDescriptor FD, DiskAddress *diskPage);
+int setMemoryOnly(Buffer *buf, fileDescriptor FD);
+int isMemoryOnly(Buffer *buf, fileDescriptor FD);
+void setMmapMode(Buffer *buf, int on);
+void adviseSequential(Buffer *buf, fileDescriptor FD);
 int findPage(Buffer *buf, DiskAddress diskPage);
 int findPageVolatile(Buffer *buf, DiskAddress diskPage);
 int allocateCachePage(Buffer *buf, DiskAddress diskpage);
@@ -51,5 +350,13 @@ int checkVolatileFiles(Buffer *buf, int FD);
 int removeFileFromPersistentList(Buffer *buf, int FD);
 int removeFileFromVolatileList(Buffer *buf, int FD);
 void deleteFile(Buffer *buf, int FD);
+void getBufferStats(Buffer *buf, BufferStats *total, std::map<int, BufferStats> *files);
+int startBgWriter(Buffer *buf, int dirtyTarget);
+void stopBgWriter(Buffer *buf);
+int startTrace(Buffer *buf, const char *path);
+void stopTrace(Buffer *buf);
+int saveWarmPages(Buffer *buf);
+int startWarmer(Buffer *buf);
+void stopWarmer(Buffer *buf);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,300 @@
+/**
+ * Replays a trace of page requests taken with FLOPPY_TRACE (see startTrace)
+ * against pools of different sizes under several replacement policies, and
+ * prints the share of requests each one misses on. Only the order of the
+ * requests matters to a policy, so a trace taken with one pool size tells
+ * what any other size would have done.
+ *
+ * To run:
+ *    make bufferSim
+ *    FLOPPY_TRACE=floppy.trace ./floppy < queries.sql
+ *    ./bufferSim floppy.trace [frames ...]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <list>
+#include <set>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "bufferManager.h"
+
+/* LRU-K looks at the K-th most recent request of each page */
+#define LRU_K 2
+
+typedef std::list<long long> PageList;
+
+/* a replacement policy over a pool of frames pages */
+class Policy {
+public:
+   Policy(int frames) : frames(frames) {}
+   virtual ~Policy() {}
+   virtual const char *name() = 0;
+   /* requests page, returns true if it was resident */
+   virtual bool access(long long page) = 0;
+protected:
+   int frames;
+};
+
+class LRU : public Policy {
+public:
+   LRU(int frames) : Policy(frames) {}
+   const char *name() { return "LRU"; }
+
+   bool access(long long page) {
+      std::unordered_map<long long, PageList::iterator>::iterator it = where.find(page);
+      if (it != where.end()) {
+         order.splice(order.begin(), order, it->second);
+         return true;
+      }
+      if ((int)where.size() == frames) {
+         where.erase(order.back());
+         order.pop_back();
+      }
+      order.push_front(page);
+      where[page] = order.begin();
+      return false;
+   }
+
+private:
+   PageList order; /* most recent first */
+   std::unordered_map<long long, PageList::iterator> where;
+};
+
+/* what the pool runs, see clockSweep() */
+class Clock : public Policy {
+public:
+   Clock(int frames) : Policy(frames), pages(frames), ref(frames), used(0), hand(0) {}
+   const char *name() { return "CLOCK"; }
+
+   bool access(long long page) {
+      std::unordered_map<long long, int>::iterator it = where.find(page);
+      if (it != where.end()) {
+         ref[it->second] = 1;
+         return true;
+      }
+
+      int num;
+      if (used < frames) {
+         num = used++;
+      }
+      else {
+         while (ref[hand]) {
+            ref[hand] = 0;
+            hand = (hand + 1) % frames;
+         }
+         num = hand;
+         hand = (hand + 1) % frames;
+         where.erase(pages[num]);
+      }
+      pages[num] = page;
+      ref[num] = 1;
+      where[page] = num;
+      return false;
+   }
+
+private:
+   std::vector<long long> pages;
+   std::vector<char> ref;
+   int used, hand;
+   std::unordered_map<long long, int> where;
+};
+
+/*
+ * Evicts the page whose K-th most recent request is oldest. Pages with fewer
+ * than K requests go first, least recently used first. The history of a page
+ * is kept after it is evicted.
+ */
+class LRUK : public Policy {
+public:
+   LRUK(int frames) : Policy(frames), now(0) {}
+   const char *name() { return "LRU-2"; }
+
+   bool access(long long page) {
+      std::vector<long long> &h = history[page];
+      bool hit = resident.count(page);
+      if (hit)
+         order.erase(entry(page, h));
+      else if ((int)resident.size() == frames)
+         evict();
+
+      if (h.empty())
+         h.assign(LRU_K, 0);
+      h.insert(h.begin(), ++now);
+      h.pop_back();
+      order.insert(entry(page, h));
+      resident.insert(page);
+      return hit;
+   }
+
+private:
+   typedef std::pair<std::pair<long long, long long>, long long> Entry;
+
+   /* (K-th most recent, most recent, page), the victim sorts first */
+   Entry entry(long long page, std::vector<long long> &h) {
+      return Entry(std::make_pair(h[LRU_K - 1], h[0]), page);
+   }
+
+   void evict() {
+      long long victim = order.begin()->second;
+      order.erase(order.begin());
+      resident.erase(victim);
+   }
+
+   long long now;
+   std::set<Entry> order;
+   std::unordered_set<long long> resident;
+   std::unordered_map<long long, std::vector<long long> > history;
+};
+
+/*
+ * Adaptive Replacement Cache: T1 holds pages seen once recently and T2 pages
+ * seen at least twice. B1 and B2 remember what was evicted from each, and a
+ * hit there moves the target size p of T1 towards the list that would have
+ * kept the page.
+ */
+class ARC : public Policy {
+public:
+   ARC(int frames) : Policy(frames), p(0) {}
+   const char *name() { return "ARC"; }
+
+   bool access(long long page) {
+      std::unordered_map<long long, Where>::iterator it = where.find(page);
+      int in = it == where.end() ? -1 : it->second.list;
+
+      if (in == T1 || in == T2) {
+         move(page, T2);
+         return true;
+      }
+      if (in == B1) {
+         int delta = size(B2) > size(B1) ? size(B2) / size(B1) : 1;
+         p = p + delta > frames ? frames : p + delta;
+         replace(false);
+         move(page, T2);
+         return false;
+      }
+      if (in == B2) {
+         int delta = size(B1) > size(B2) ? size(B1) / size(B2) : 1;
+         p = p - delta < 0 ? 0 : p - delta;
+         replace(true);
+         move(page, T2);
+         return false;
+      }
+
+      int l1 = size(T1) + size(B1), total = l1 + size(T2) + size(B2);
+      if (l1 == frames) {
+         if (size(T1) < frames) {
+            drop(B1);
+            replace(false);
+         }
+         else {
+            drop(T1);
+         }
+      }
+      else if (total >= frames) {
+         if (total == 2 * frames)
+            drop(B2);
+         replace(false);
+      }
+      lists[T1].push_front(page);
+      where[page] = Where(T1, lists[T1].begin());
+      return false;
+   }
+
+private:
+   enum { T1, T2, B1, B2 };
+
+   struct Where {
+      Where() {}
+      Where(int list, PageList::iterator it) : list(list), it(it) {}
+      int list;
+      PageList::iterator it;
+   };
+
+   int size(int list) { return lists[list].size(); }
+
+   /* makes page the most recent of list */
+   void move(long long page, int list) {
+      Where &w = where[page];
+      lists[list].splice(lists[list].begin(), lists[w.list], w.it);
+      w.list = list;
+      w.it = lists[list].begin();
+   }
+
+   /* forgets the least recent page of list */
+   void drop(int list) {
+      where.erase(lists[list].back());
+      lists[list].pop_back();
+   }
+
+   /* evicts from T1 or T2 to make room, keeping the page in B1 or B2 */
+   void replace(bool inB2) {
+      if (size(T1) && (size(T1) > p || (inB2 && size(T1) == p)))
+         move(lists[T1].back(), B1);
+      else if (size(T2))
+         move(lists[T2].back(), B2);
+   }
+
+   int p;
+   PageList lists[4];
+   std::unordered_map<long long, Where> where;
+};
+
+static double missRatio(Policy *policy, std::vector<long long> &trace) {
+   long long misses = 0;
+   for (size_t i = 0; i < trace.size(); i++)
+      misses += !policy->access(trace[i]);
+   return trace.empty() ? 0 : (double)misses / trace.size();
+}
+
+int main(int argc, char **argv) {
+   if (argc < 2) {
+      fprintf(stderr, "usage: %s trace [frames ...]\n", argv[0]);
+      return 1;
+   }
+   FILE *in = fopen(argv[1], "rb");
+   if (!in) {
+      perror(argv[1]);
+      return 1;
+   }
+
+   std::vector<long long> trace;
+   std::unordered_set<long long> distinct;
+   TraceRecord records[TRACE_BATCH];
+   size_t n;
+   while ((n = fread(records, sizeof(TraceRecord), TRACE_BATCH, in)) > 0) {
+      for (size_t i = 0; i < n; i++) {
+         long long page = ((long long)records[i].FD << 32) | records[i].pageId;
+         trace.push_back(page);
+         distinct.insert(page);
+      }
+   }
+   fclose(in);
+
+   /* doubling up to where everything fits, unless told otherwise */
+   std::vector<int> sizes;
+   for (int i = 2; i < argc; i++)
+      sizes.push_back(atoi(argv[i]));
+   if (sizes.empty()) {
+      int all = distinct.size();
+      for (int frames = 16; frames < all; frames *= 2)
+         sizes.push_back(frames);
+      sizes.push_back(all > 0 ? all : 1);
+   }
+
+   printf("%zu requests, %zu pages\n", trace.size(), distinct.size());
+   printf("%10s %10s %10s %10s %10s\n", "frames", "LRU", "CLOCK", "LRU-2", "ARC");
+   for (size_t s = 0; s < sizes.size(); s++) {
+      int frames = sizes[s];
+      if (frames < 1)
+         continue;
+      Policy *policies[] = {new LRU(frames), new Clock(frames), new LRUK(frames), new ARC(frames)};
+      printf("%10d", frames);
+      for (int i = 0; i < 4; i++) {
+         printf(" %10.4f", missRatio(policies[i], trace));
+         delete policies[i];
+      }
+      printf("\n");
+   }
+   return 0;
+}
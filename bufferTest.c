@@ -1,44 +1,45 @@
 /** 
  * Runs a test program in batch mode for the buffer manager.
  */
-#include <time.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <thread>
+#include <vector>
+#include <map>
+#include <string>
 #include "tinyFS.h"
 #include "bufferManager.h"
 #include "bufferTest.h"
 
 /* prints out the metadata of blocks in the buffer 
- * FORMAT: index#: [(fileDescriptor, pageID), timestamp, pinned, dirty flag]
+ * FORMAT: index#: [(fileDescriptor, pageID), reference bit, pinned, dirty flag]
+ * The frame each partition's CLOCK hand will inspect next is marked with "<- hand".
  */
 void checkpoint(Buffer *buf) {
    int i;
-   char ctimeBuff[256];
    
    for(i = 0; i < buf->nBufferBlocks; i++) {
       printf("%d:",i);
       
-      if (buf->buffer_timestamp[i] < 0) {
-         printf("[%s]\n", EMPTY);
+      if (buf->buffer_ref[i] < 0) {
+         printf("[%s]", EMPTY);
       }
       else {
-         strcpy(ctimeBuff, ctime(&(buf->buffer_timestamp[i])));
-         ctimeBuff[strlen(ctimeBuff) - 1] = '\0';
-      
-         printf("[(%d,%d),", buf->pages[i].address.FD, buf->pages[i].address.pageId);
-         printf("%s,%d,%d]\n", ctimeBuff, buf->pin[i], buf->dirty[i]); 
+         printf("[(%d,%d),", buf->frameAddr[i].FD, buf->frameAddr[i].pageId);
+         printf("%d,%d,%d]", buf->buffer_ref[i], buf->pin[i], buf->dirty[i]); 
       }
+      printf(i == buf->parts[i % buf->nPartitions].hand ? " <- hand\n" : "\n");
    }
 }
 
 int pageDump(Buffer *buf, int index) {
-   if (buf->buffer_timestamp[index] < 0) {
+   if (buf->buffer_ref[index] < 0) {
       printf("No valid block at index %d\n", index); 
       return -1;
    }
    else {
-      printf("%s\n", buf->pages[index].block);
+      printf("%s\n", frameBlock(buf, index));
    }
    
    return 0;
@@ -73,6 +74,100 @@ int printBlock(Buffer *buf, DiskAddress diskPage) {
    return 0;
 }
 
+/* checks that end with FAIL, end exits with 1 if there were any */
+int failures = 0;
+
+/* opens each file once, so every command on a file name gets the same FD
+ * and refers to the same pages in the buffer */
+fileDescriptor openNamed(char *name) {
+   static std::map<std::string, fileDescriptor> fds;
+   std::map<std::string, fileDescriptor>::iterator it = fds.find(name);
+   if (it == fds.end())
+      it = fds.insert(std::make_pair(std::string(name), tfs_openFile(name))).first;
+   return it->second;
+}
+
+/* one thread of runThreads: rounds accesses to random pages of fd, which
+ * increment the counter at the start of the page under an exclusive latch
+ * half of the time and read it under a shared one otherwise. Every
+ * increment is counted in adds. */
+static void hammer(Buffer *buf, fileDescriptor fd, int pages, int rounds,
+ unsigned int seed, int *adds) {
+   DiskAddress page;
+   int i;
+
+   page.FD = fd;
+   for (i = 0; i < rounds; i++) {
+      page.pageId = rand_r(&seed) % pages;
+      PageGuard guard(buf, page);
+      if (!guard.valid())
+         continue;
+      if (rand_r(&seed) & 1) {
+         guard.latch(LATCH_EXCLUSIVE);
+         (*(int *)guard.data())++;
+         guard.markDirty();
+         guard.unlatch();
+         adds[page.pageId]++;
+      }
+      else {
+         guard.latch(LATCH_SHARED);
+         if (*(int *)guard.data() < 0)
+            printf("threads: FAIL page %d went negative\n", page.pageId);
+         guard.unlatch();
+      }
+   }
+}
+
+/*
+ * Runs n threads of hammer against the pool over a file of pages zeroed
+ * pages, then writes everything back and checks that no increment got lost
+ * on the way through the pool and to disk.
+ */
+void runThreads(Buffer *buf, char *name, int n, int pages, int rounds) {
+   std::vector<std::thread> threads;
+   std::vector<int> adds((size_t)n * pages, 0);
+   unsigned char *block = (unsigned char *)calloc(1, BLOCKSIZE);
+   fileDescriptor fd = openNamed(name);
+   int i, t, sum, bad = 0;
+
+   for (i = 0; i < pages; i++)
+      tfs_writePage(fd, i, block);
+   for (t = 0; t < n; t++)
+      threads.push_back(std::thread(hammer, buf, fd, pages, rounds, t + 1,
+       &adds[(size_t)t * pages]));
+   for (t = 0; t < n; t++)
+      threads[t].join();
+   flushAll(buf);
+
+   for (i = 0; i < pages; i++) {
+      for (sum = 0, t = 0; t < n; t++)
+         sum += adds[(size_t)t * pages + i];
+      tfs_readPage(fd, i, block);
+      if (*(int *)block != sum && bad++ < 10)
+         printf("threads: FAIL page %d has %d, expected %d\n", i, *(int *)block, sum);
+   }
+   failures += bad;
+   if (!bad)
+      printf("threads: ok\n");
+   free(block);
+}
+
+/*
+ * Scans pages first through last of fd through a scan ring, the way a
+ * TupleIterator does: each page is pinned, then read again while pinned.
+ */
+void scanPages(Buffer *buf, fileDescriptor fd, int first, int last) {
+   BufferRing *ring = getScanRing(buf, last - first + 1);
+   DiskAddress page;
+
+   page.FD = fd;
+   for (page.pageId = first; page.pageId <= last; page.pageId++) {
+      PageGuard pin(buf, page, ring);
+      PageGuard read(buf, page, ring, LATCH_SHARED);
+   }
+   freeBufferRing(ring);
+}
+
 int main(int argc, char **argv) {
 if (argc < 2) {
       perror("usage: ./bufferTest <filename>");
@@ -89,15 +184,15 @@ if (argc < 2) {
       exit(1);
    }
 
-   Buffer *buf = malloc(sizeof(Buffer));
-   char *buffer = malloc(15);
+   Buffer *buf = (Buffer *)malloc(sizeof(Buffer));
+   char *buffer = (char *)malloc(15);
    char x[25];
    char *ptr;
    int ret;
    int ret2;
    int i;
    fileDescriptor fd;
-   DiskAddress *diskPage = malloc(10 * sizeof(DiskAddress));
+   DiskAddress *diskPage = (DiskAddress *)malloc(10 * sizeof(DiskAddress));
    DiskAddress temp;
    int da_ct = 0;
 
@@ -112,14 +207,36 @@ if (argc < 2) {
          ret = (int)strtol(buffer, &ptr, 10);
          commence(x, buf, ret, ret);
       } 
+      else if (strcmp(buffer, "arena") == 0) { /* a pool that can grow to max */
+         int max;
+         fscanf(fp, "%s %d %d", x, &ret, &max);
+         commenceArena(x, buf, ret, ret, max, ARENA_SMALL_PAGES);
+      }
+      else if (strcmp(buffer, "resize") == 0) { /* expects ok or fail */
+         fscanf(fp, "%d %s", &ret, buffer);
+         if ((resizeBuffer(buf, ret) == 0) != (strcmp(buffer, "ok") == 0)) {
+            printf("resize: FAIL %d blocks, expected %s\n", ret, buffer);
+            failures++;
+         }
+      }
+      else if (strcmp(buffer, "frames") == 0) { /* at most this many resident */
+         BufferStats stats;
+         fscanf(fp, "%d", &ret);
+         getBufferStats(buf, &stats, NULL);
+         if (stats.resident > ret) {
+            printf("frames: FAIL %d resident, expected at most %d\n",
+             stats.resident, ret);
+            failures++;
+         }
+      }
       else if (strcmp(buffer, "end") == 0) {
          squash(buf);
-         exit(0);
+         exit(failures ? 1 : 0);
       }
       else if (strcmp(buffer,"read") == 0) {
          fscanf(fp, "%s", buffer); /*filename*/
          strcpy(x, buffer);
-         fd = tfs_openFile(x);
+         fd = openNamed(x);
          temp.FD = fd;
          fscanf(fp, "%s", buffer);
          ret = (int)strtol(buffer, &ptr, 10);
@@ -129,7 +246,7 @@ if (argc < 2) {
       else if (strcmp(buffer,"write") == 0) {
          fscanf(fp, "%s", buffer); /*filename*/
          strcpy(x, buffer);
-         fd = tfs_openFile(x);
+         fd = openNamed(x);
          temp.FD = fd;
          fscanf(fp, "%s", buffer);
          ret = (int)strtol(buffer, &ptr, 10);
@@ -139,7 +256,7 @@ if (argc < 2) {
       else if (strcmp(buffer,"flush") == 0) {
          fscanf(fp, "%s", buffer); /*filename*/
          strcpy(x, buffer);
-         fd = tfs_openFile(x);
+         fd = openNamed(x);
          temp.FD = fd;
          fscanf(fp, "%s", buffer);
          ret = (int)strtol(buffer, &ptr, 10);
@@ -149,7 +266,7 @@ if (argc < 2) {
       else if (strcmp(buffer,"pin") == 0) {
          fscanf(fp, "%s", buffer); /*filename*/
          strcpy(x, buffer);
-         fd = tfs_openFile(x);
+         fd = openNamed(x);
          temp.FD = fd;
          fscanf(fp, "%s", buffer);
          ret = (int)strtol(buffer, &ptr, 10);
@@ -159,7 +276,7 @@ if (argc < 2) {
       else if (strcmp(buffer,"unpin") == 0) {
          fscanf(fp, "%s", buffer); /*filename*/
          strcpy(x, buffer);
-         fd = tfs_openFile(x);
+         fd = openNamed(x);
          temp.FD = fd;
          fscanf(fp, "%s", buffer);
          ret = (int)strtol(buffer, &ptr, 10);
@@ -169,7 +286,7 @@ if (argc < 2) {
       else if (strcmp(buffer, "new") == 0) {
          fscanf(fp, "%s", buffer); /*filename*/
          strcpy(x, buffer);
-         fd = tfs_openFile(x);
+         fd = openNamed(x);
          fscanf(fp, "%s", buffer);
          ret = (int)strtol(buffer, &ptr, 10);
          fscanf(fp, "%s", buffer);
@@ -183,6 +300,43 @@ if (argc < 2) {
       else if (strcmp(buffer, "check") == 0) {
          checkpoint(buf);
       }
+      else if (strcmp(buffer, "scan") == 0) {
+         int first, last;
+         fscanf(fp, "%s %d %d", x, &first, &last);
+         scanPages(buf, openNamed(x), first, last);
+      }
+      else if (strcmp(buffer, "resident") == 0 || strcmp(buffer, "absent") == 0) {
+         int want = strcmp(buffer, "resident") == 0;
+         fscanf(fp, "%s %d", x, &ret);
+         temp.FD = openNamed(x);
+         temp.pageId = ret;
+         if ((findPage(buf, temp) != -1) != want) {
+            printf("%s: FAIL page %d of %s\n", buffer, ret, x);
+            failures++;
+         }
+      }
+      else if (strcmp(buffer, "mmap") == 0) { /* before any page is read */
+         setMmapMode(buf, 1);
+      }
+      else if (strcmp(buffer, "hello") == 0) { /* page still holds what new wrote */
+         fscanf(fp, "%s %d", x, &ret);
+         temp.FD = openNamed(x);
+         temp.pageId = ret;
+         PageGuard page(buf, temp, NULL, LATCH_SHARED);
+         if (!page.valid() || strcmp(page.data(), "Hello World!") != 0) {
+            printf("hello: FAIL page %d of %s\n", ret, x);
+            failures++;
+         }
+      }
+      else if (strcmp(buffer, "writer") == 0) {
+         fscanf(fp, "%s", buffer); /*dirty target*/
+         startBgWriter(buf, (int)strtol(buffer, &ptr, 10));
+      }
+      else if (strcmp(buffer, "threads") == 0) {
+         int n, pages, rounds;
+         fscanf(fp, "%d %s %d %d", &n, x, &pages, &rounds);
+         runThreads(buf, x, n, pages, rounds);
+      }
       else /* default: */ {
          printf("invalid operation\n");
       }
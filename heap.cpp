@@ -1,3 +1,4 @@
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <string>
@@ -32,6 +33,38 @@ int sizeOfRecordDesc(RecordDesc recordDesc) {
    return size;
 }
 
+// Lays out a page of recordSize byte records: the HeapPageHeader and the
+// bitmap, then as many records as fit. DEFAULT_BLOCKSIZE pages keep the fixed
+// PAGE_HDR_SIZE header they always had, bigger pages only reserve what the
+// bitmap needs. Returns the number of records and sets *headerSize to where
+// the first one starts.
+static int pageLayout(int recordSize, int *headerSize) {
+   int maxRecords;
+   if (BLOCKSIZE == DEFAULT_BLOCKSIZE) {
+      *headerSize = PAGE_HDR_SIZE;
+      return (BLOCKSIZE - PAGE_HDR_SIZE) / recordSize;
+   }
+
+   // each record costs recordSize bytes and a bit, the bitmap a byte more
+   maxRecords = (BLOCKSIZE - (int)sizeof(HeapPageHeader) - 1) * 8 / (8 * recordSize + 1);
+   for (;; maxRecords--) { // rounding the header up may cost a record
+      *headerSize = (sizeof(HeapPageHeader) + maxRecords / 8 + 1 + 7) & ~7;
+      if (*headerSize + maxRecords * recordSize <= BLOCKSIZE)
+         return maxRecords;
+   }
+}
+
+int pageHeaderSize(int recordSize) {
+   int headerSize;
+   pageLayout(recordSize, &headerSize);
+   return headerSize;
+}
+
+int pageMaxRecords(int recordSize) {
+   int headerSize;
+   return pageLayout(recordSize, &headerSize);
+}
+
 // Make a second page right after the file header to store info about primary/foreign keys.
 // Page has this structure:
 //  int num fields in primary key
@@ -42,8 +75,11 @@ int sizeOfRecordDesc(RecordDesc recordDesc) {
 //         num * char[NAME_LEN]  field names)
 
 void getKeys(Buffer *buf, int fd, FLOPPYPrimaryKey *pk, vector<FLOPPYForeignKey *> *fks) {
-   DiskAddress addr{fd, 1};
-   char *page = read(buf, addr, 0, BLOCKSIZE);
+   PageSpan span(buf, DiskAddress{fd, 1}, 0, BLOCKSIZE);
+   if (!span.valid())
+      return;
+
+   const char *page = span.data();
    int num;
 
    pk->attributes = new vector<char *>;
@@ -85,12 +121,14 @@ void getKeys(Buffer *buf, int fd, FLOPPYPrimaryKey *pk, vector<FLOPPYForeignKey
 }
 
 void createKeyPage(Buffer *buf, int fd, FLOPPYPrimaryKey *pk, vector<FLOPPYForeignKey *> *fk) {
-   char page[BLOCKSIZE];
    int num, byte;
 
    if (!pk)
       return;
 
+   vector<char> bytes(BLOCKSIZE);
+   char *page = &bytes[0];
+
    num = pk->attributes->size();
    memcpy(page, &num, sizeof(int));
    byte = sizeof(int);
@@ -129,6 +167,175 @@ void createKeyPage(Buffer *buf, int fd, FLOPPYPrimaryKey *pk, vector<FLOPPYForei
 }
 
 
+// Notes that file's header is about to change. The first change after it
+// was read marks page 0 open and writes it out at once, so that the disk
+// tells when its header may be stale; closeHeapFiles clears the mark.
+static int markHeaderDirty(Buffer *buf, int fd, HeapFile *file) {
+   file->dirty = 1;
+   if (file->header.open || file->header.isVolatile)
+      return 0;
+
+   DiskAddress addr{fd, 0};
+   PageGuard pin(buf, addr); // page 0 stays in until it is written out
+   file->header.open = 1;
+   if (writePersistent(buf, addr, 0, sizeof(HeapFileHeader), (char *)&file->header,
+    sizeof(HeapFileHeader)) < 0 || flushPage(buf, addr) < 0) {
+      file->header.open = 0;
+      return -1;
+   }
+   return 0;
+}
+
+// Sets page to page id's header if it is a heap page of header's file that
+// made it to the disk (a page that did not reads as zeros).
+static int readHeapPage(Buffer *buf, int fd, int id, const HeapFileHeader *header,
+ HeapPageHeader *page) {
+   if (readInto(buf, DiskAddress{fd, id}, 0, sizeof(HeapPageHeader), (char *)page) < 0)
+      return -1;
+   if (page->pageId != id || strncmp(page->filename, header->tableName, NAME_LEN))
+      return -1;
+   return 0;
+}
+
+// Puts right a header found open, which a crash may have left behind the
+// pages it describes. The page list is walked for the last page and the
+// counts, the first page looked for among all of them if page 0 never got
+// its id. A page that did not make it to the disk ends the list, and the
+// records on it and after it are lost. The free-space map is dropped, to
+// be built again from the page headers (see buildFreeMap()), which leaves
+// the pages of the old one unused. Called with the HeapFileTable latch held.
+static int recoverHeader(Buffer *buf, int fd, HeapFileHeader *header) {
+   HeapPageHeader page;
+   int id = header->pageList, last = 0, numBlocks = 0, numTuples = 0;
+
+   for (int i = 1, n = tfs_numPages(fd); id == -1 && i < n; i++) {
+      if (readHeapPage(buf, fd, i, header, &page) == 0)
+         id = i;
+   }
+   header->pageList = id;
+
+   while (id != -1 && readHeapPage(buf, fd, id, header, &page) == 0) {
+      last = id;
+      numBlocks++;
+      numTuples += page.occupied;
+      id = page.nextPage;
+   }
+   if (id != -1 && last && pHSetNextPage(buf, DiskAddress{fd, last}, -1) < 0)
+      return -1;
+   if (!last)
+      header->pageList = -1;
+
+   header->lastPage = last;
+   header->numBlocks = numBlocks;
+   header->numTuples = numTuples;
+   header->freeMap = 0;
+   return 0;
+}
+
+// The file header getters and setters work on the copy in buf's
+// HeapFileTable, holding its latch through a HeapFilesLock. The copy is read
+// from page 0 the first time the file is used and only put back there when
+// the pool flushes, so none of them go through the buffer. A crash can leave
+// page 0 behind the rest of the file; page 0 is marked open while that may
+// be so, and a header read with the mark still set is recovered from the
+// heap pages before it is used (see recoverHeader()).
+class HeapFilesLock {
+public:
+   HeapFilesLock(Buffer *buf)
+    : buf(buf), table((HeapFileTable *)buf->hooks.state), lock(table->latch) {}
+
+   // fd's header, NULL if page 0 can't be read
+   const HeapFileHeader *get(int fd) {
+      HeapFile *f = file(fd);
+      return f ? &f->header : NULL;
+   }
+
+   // same, for a caller about to change it
+   HeapFileHeader *change(int fd) {
+      HeapFile *f = file(fd);
+      if (!f || markHeaderDirty(buf, fd, f) < 0)
+         return NULL;
+
+      return &f->header;
+   }
+
+   // all that is kept of fd, for a caller that sets dirty itself
+   HeapFile *file(int fd) {
+      auto it = table->files.find(fd);
+      if (it != table->files.end())
+         return &it->second;
+
+      HeapFile file;
+      if (readInto(buf, DiskAddress{fd, 0}, 0, sizeof(HeapFileHeader), (char *)&file.header) < 0)
+         return NULL;
+      file.dirty = 0;
+      if (file.header.open && !file.header.isVolatile) {
+         if (recoverHeader(buf, fd, &file.header) < 0)
+            return NULL;
+         file.dirty = 1;
+      }
+      file.mapLoaded = 0;
+      file.freeHint = 0;
+      return &(table->files[fd] = file);
+   }
+
+private:
+   Buffer *buf;
+   HeapFileTable *table;
+   std::lock_guard<std::mutex> lock;
+};
+
+// the pool's flush hook, puts the changed headers back on their page 0,
+// still marked open
+static void flushHeapFiles(Buffer *buf) {
+   HeapFileTable *table = (HeapFileTable *)buf->hooks.state;
+   std::lock_guard<std::mutex> lock(table->latch);
+
+   for (auto it = table->files.begin(); it != table->files.end(); it++) {
+      if (!it->second.dirty)
+         continue;
+
+      DiskAddress addr{it->first, 0};
+      if (writePersistent(buf, addr, 0, sizeof(HeapFileHeader),
+       (char *)&it->second.header, sizeof(HeapFileHeader)) == 0)
+         it->second.dirty = 0;
+   }
+}
+
+// the pool's drop hook, forgets the header of a file being deleted
+static void dropHeapFile(Buffer *buf, fileDescriptor fd) {
+   HeapFileTable *table = (HeapFileTable *)buf->hooks.state;
+   std::lock_guard<std::mutex> lock(table->latch);
+   table->files.erase(fd);
+}
+
+// Keeps the header of every heap file in use in memory from now on. Must be
+// called once the pool is up and before any heap file is touched.
+void openHeapFiles(Buffer *buf) {
+   buf->hooks.state = new HeapFileTable;
+   buf->hooks.flush = flushHeapFiles;
+   buf->hooks.drop = dropHeapFile;
+}
+
+// Puts the headers back on their pages and stops keeping them, before squash.
+// The open mark is cleared only once everything else is on disk.
+void closeHeapFiles(Buffer *buf) {
+   HeapFileTable *table = (HeapFileTable *)buf->hooks.state;
+
+   if (flushAll(buf) >= 0) {
+      std::lock_guard<std::mutex> lock(table->latch);
+      for (auto it = table->files.begin(); it != table->files.end(); it++) {
+         if (it->second.header.open) {
+            it->second.header.open = 0;
+            it->second.dirty = 1;
+         }
+      }
+   }
+   flushHeapFiles(buf);
+   delete table;
+   memset(&buf->hooks, 0, sizeof(FileHooks));
+}
+
 int createHeapFile(Buffer *buf, char *filename, RecordDesc recordDesc, int isVolatile,
  FLOPPYPrimaryKey *pk, vector<FLOPPYForeignKey *> *fk) {
    HeapFileHeader header;
@@ -145,24 +352,23 @@ int createHeapFile(Buffer *buf, char *filename, RecordDesc recordDesc, int isVol
    header.numBlocks = header.numTuples = 0;
 
    header.isVolatile = isVolatile;
+   header.freeMap = 0;
+   header.open = 0;
    
    fileDescriptor fd = getFd(filename);
    DiskAddress addr;
 
+   // a volatile table lives in memory only and is never written to its file
+   if (isVolatile && setMemoryOnly(buf, fd) < 0)
+      return -1;
+
+   // nothing kept from a file of the same name that went before
+   dropHeapFile(buf, fd);
+
    newPage(buf, fd, &addr);
    writePersistent(buf, addr, 0, sizeof(HeapFileHeader), (char *)&header, sizeof(HeapFileHeader));
 
    createKeyPage(buf, fd, pk, fk);
-
-   //
-   //if (table->isVolatile) {
-   //   writeVolatile(buf, addr, 0, sizeof(HeapFileHeader), (char *)&header, sizeof(HeapFileHeader));
-   //   addVolatileFile(buf, fd);
-   //}
-   //else {
-   //   writePersistent(buf, addr, 0, sizeof(HeapFileHeader), (char *)&header, sizeof(HeapFileHeader));
-   //   addPersistentFile(buf, fd);
-   //}
    return fd;
 }
 
@@ -171,22 +377,19 @@ int deleteHeapFile(Buffer *buf, char *tableName) {
    return 0;
 }
 
-HeapFileHeader *getFileHeader(Buffer *buf, fileDescriptor fd) {
-   DiskAddress addr;
-   addr.FD = fd;
-   addr.pageId = 0;
-
-   int i = readPage(buf, addr);
-   return (HeapFileHeader *)read(buf, addr, 0, sizeof(HeapFileHeader));
+// The page header getters look at the headers where they sit in the buffer
+// through a PageSpan, the setters change them there through a PageEdit.
+static const HeapPageHeader *pageHeader(PageSpan &span) {
+   return span.valid() ? (const HeapPageHeader *)span.data() : NULL;
 }
 
-HeapPageHeader *getPageHeader(Buffer *buf, DiskAddress addr) {
-   readPage(buf, addr);
-   return (HeapPageHeader *)read(buf, addr, 0, sizeof(HeapPageHeader));
+static HeapPageHeader *pageHeader(PageEdit &edit) {
+   return edit.valid() ? (HeapPageHeader *)edit.data() : NULL;
 }
 
 int heapHeaderGetTableName(Buffer *buf, fileDescriptor fd, char *name) {
-   HeapFileHeader *header = getFileHeader(buf, fd);
+   HeapFilesLock files(buf);
+   const HeapFileHeader *header = files.get(fd);
    if (!header) {
       return -1;
    }
@@ -196,7 +399,8 @@ int heapHeaderGetTableName(Buffer *buf, fileDescriptor fd, char *name) {
 }
 
 int heapHeaderGetRecordDesc(Buffer *buf, fileDescriptor fd, RecordDesc *recordDesc) {
-   HeapFileHeader *header = getFileHeader(buf, fd);
+   HeapFilesLock files(buf);
+   const HeapFileHeader *header = files.get(fd);
    if (!header)
       return -1;
 
@@ -205,7 +409,8 @@ int heapHeaderGetRecordDesc(Buffer *buf, fileDescriptor fd, RecordDesc *recordDe
 }
 
 int heapHeaderGetNextPage(Buffer *buf, fileDescriptor fd, DiskAddress *page) {
-   HeapFileHeader *header = getFileHeader(buf, fd);
+   HeapFilesLock files(buf);
+   const HeapFileHeader *header = files.get(fd);
    if (!header)
       return -1;
 
@@ -215,7 +420,8 @@ int heapHeaderGetNextPage(Buffer *buf, fileDescriptor fd, DiskAddress *page) {
 }
 
 int heapHeaderGetLastPage(Buffer *buf, fileDescriptor fd, DiskAddress *page) {
-   HeapFileHeader *header = getFileHeader(buf, fd);
+   HeapFilesLock files(buf);
+   const HeapFileHeader *header = files.get(fd);
    if (!header)
       return -1;
 
@@ -224,18 +430,9 @@ int heapHeaderGetLastPage(Buffer *buf, fileDescriptor fd, DiskAddress *page) {
    return 0;
 }
 
-int heapHeaderGetFreeSpace(Buffer *buf, fileDescriptor fd, DiskAddress *page) {
-   HeapFileHeader *header = getFileHeader(buf, fd);
-   if (!header)
-      return -1;
-
-   page->FD = fd;
-   page->pageId = header->freeList;
-   return 0;
-}
-
 int heapHeaderGetRecordSize(Buffer *buf, fileDescriptor fd, int *recordSize) {
-   HeapFileHeader *header = getFileHeader(buf, fd);
+   HeapFilesLock files(buf);
+   const HeapFileHeader *header = files.get(fd);
    if (!header)
       return -1;
 
@@ -244,46 +441,28 @@ int heapHeaderGetRecordSize(Buffer *buf, fileDescriptor fd, int *recordSize) {
 }
 
 int heapHeaderSetNextPage(Buffer *buf, fileDescriptor fd, int nextPage) {
-   HeapFileHeader *header = getFileHeader(buf, fd);
+   HeapFilesLock files(buf);
+   HeapFileHeader *header = files.change(fd);
    if (!header)
       return -1;
 
    header->pageList = nextPage;
-   DiskAddress addr;
-   addr.FD = fd;
-   addr.pageId = 0;
-   write(buf, addr, 0, sizeof(HeapFileHeader), (char *)header, sizeof(HeapFileHeader));
    return 0;
 }
 
 int heapHeaderSetLastPage(Buffer *buf, fileDescriptor fd, int lastPage) {
-   HeapFileHeader *header = getFileHeader(buf, fd);
+   HeapFilesLock files(buf);
+   HeapFileHeader *header = files.change(fd);
    if (!header)
       return -1;
 
    header->lastPage = lastPage;
-   DiskAddress addr;
-   addr.FD = fd;
-   addr.pageId = 0;
-   write(buf, addr, 0, sizeof(HeapFileHeader), (char *)header, sizeof(HeapFileHeader));
-   return 0;
-}
-
-int heapHeaderSetFreeSpace(Buffer *buf, fileDescriptor fd, int freePage) {
-   HeapFileHeader *header = getFileHeader(buf, fd);
-   if (!header)
-      return -1;
-
-   header->freeList = freePage;
-   DiskAddress addr;
-   addr.FD = fd;
-   addr.pageId = 0;
-   write(buf, addr, 0, sizeof(HeapFileHeader), (char *)header, sizeof(HeapFileHeader));
    return 0;
 }
 
 int heapHeaderGetNumBlocks(Buffer *buf, int fd, int *numBlocks) {
-   HeapFileHeader *header = getFileHeader(buf, fd);
+   HeapFilesLock files(buf);
+   const HeapFileHeader *header = files.get(fd);
    if (!header)
       return -1;
    
@@ -292,7 +471,8 @@ int heapHeaderGetNumBlocks(Buffer *buf, int fd, int *numBlocks) {
 }
 
 int heapHeaderGetNumTuples(Buffer *buf, int fd, int *numTuples) {
-   HeapFileHeader *header = getFileHeader(buf, fd);
+   HeapFilesLock files(buf);
+   const HeapFileHeader *header = files.get(fd);
    if (!header)
       return -1;
       
@@ -301,7 +481,8 @@ int heapHeaderGetNumTuples(Buffer *buf, int fd, int *numTuples) {
 }
 
 int heapHeaderIsVolatile(Buffer *buf, int fd, int *isVolatile) {
-   HeapFileHeader *header = getFileHeader(buf, fd);
+   HeapFilesLock files(buf);
+   const HeapFileHeader *header = files.get(fd);
    if (!header)
       return -1;
 
@@ -310,61 +491,57 @@ int heapHeaderIsVolatile(Buffer *buf, int fd, int *isVolatile) {
 }
 
 int heapHeaderIncrementNumBlocks(Buffer *buf, int fd) {
-   HeapFileHeader *header = getFileHeader(buf, fd);
+   HeapFilesLock files(buf);
+   HeapFileHeader *header = files.change(fd);
    if (!header)
       return -1;
       
    header->numBlocks++;
-
-   DiskAddress addr;
-   addr.FD = fd;
-   addr.pageId = 0;
-   write(buf, addr, 0, sizeof(HeapFileHeader), (char *)header, sizeof(HeapFileHeader));
    return 0;
 }
 
 int heapHeaderIncrementNumTuples(Buffer *buf, int fd) {
-   HeapFileHeader *header = getFileHeader(buf, fd);
+   HeapFilesLock files(buf);
+   HeapFileHeader *header = files.change(fd);
    if (!header)
       return -1;
 
    header->numTuples++;
+   return 0;
+}
 
-   DiskAddress addr;
-   addr.FD = fd;
-   addr.pageId = 0;
-   write(buf, addr, 0, sizeof(HeapFileHeader), (char *)header, sizeof(HeapFileHeader));
+int heapHeaderAddNumTuples(Buffer *buf, int fd, int n) {
+   HeapFilesLock files(buf);
+   HeapFileHeader *header = files.change(fd);
+   if (!header)
+      return -1;
+
+   header->numTuples += n;
    return 0;
 }
 
 int heapHeaderDecrementNumTuples(Buffer *buf, int fd) {
-   HeapFileHeader *header = getFileHeader(buf, fd);
+   HeapFilesLock files(buf);
+   HeapFileHeader *header = files.change(fd);
    if (!header)
       return -1;
    
    header->numTuples--;
-
-   DiskAddress addr;
-   addr.FD = fd;
-   addr.pageId = 0;
-   write(buf, addr, 0, sizeof(HeapFileHeader), (char *)header, sizeof(HeapFileHeader));
    return 0;
 }
 
-int getRecord(Buffer *buf, DiskAddress page, int recordId, char *bytes) {
+int getRecord(Buffer *buf, DiskAddress page, int recordId, char *bytes,
+ BufferRing *ring) {
    int recordSize;
    if (heapHeaderGetRecordSize(buf, page.FD, &recordSize) < 0)
       return -1;
 
-   // TODO figure out volatile stuff
-   //if (checkPersistentFiles(buf, page.FD) >= 0)
-      readPage(buf, page);
-   //else
-   //   allocateCachePage(buf, page);
+   PageSpan record(buf, page, pageHeaderSize(recordSize) + recordId * recordSize,
+    recordSize, ring);
+   if (!record.valid())
+      return -1;
 
-   char *record = read(buf, page,
-    PAGE_HDR_SIZE + recordId * recordSize, recordSize);
-   memcpy(bytes, record, recordSize);
+   memcpy(bytes, record.data(), record.size());
    return 0;
 }
 
@@ -373,17 +550,17 @@ int putRecord(Buffer *buf, DiskAddress page, int recordId, char *bytes) {
    if (heapHeaderGetRecordSize(buf, page.FD, &recordSize) < 0)
       return -1;
 
-   if (checkPersistentFiles(buf, page.FD) >= 0)
-      readPage(buf, page);
-   else
-      allocateCachePage(buf, page);
+   PageEdit record(buf, page, pageHeaderSize(recordSize) + recordId * recordSize, recordSize);
+   if (!record.valid())
+      return -1;
 
-   return write(buf, page, PAGE_HDR_SIZE + recordId * recordSize,
-    recordSize, bytes, recordSize);
+   memcpy(record.data(), bytes, record.size());
+   return 0;
 }
 
 int pHGetMaxRecords(Buffer *buf, DiskAddress page, int *maxRecords) {
-   HeapPageHeader *header = getPageHeader(buf, page);
+   PageSpan span(buf, page, 0, sizeof(HeapPageHeader));
+   const HeapPageHeader *header = pageHeader(span);
    if (!header)
       return -1;
 
@@ -392,7 +569,8 @@ int pHGetMaxRecords(Buffer *buf, DiskAddress page, int *maxRecords) {
 }
 
 int pHGetNumRecords(Buffer *buf, DiskAddress page, int *numRecords) {
-   HeapPageHeader *header = getPageHeader(buf, page);
+   PageSpan span(buf, page, 0, sizeof(HeapPageHeader));
+   const HeapPageHeader *header = pageHeader(span);
    if (!header)
       return -1;
 
@@ -400,18 +578,20 @@ int pHGetNumRecords(Buffer *buf, DiskAddress page, int *numRecords) {
    return 0;
 }
 
-int pHGetBitmap(Buffer *buf, DiskAddress page, char *bitmap) {
-   HeapPageHeader *header = getPageHeader(buf, page);
+int pHGetBitmap(Buffer *buf, DiskAddress page, char *bitmap, BufferRing *ring) {
+   PageSpan span(buf, page, 0, BLOCKSIZE, ring);
+   const HeapPageHeader *header = pageHeader(span);
    if (!header)
       return -1;
 
-   int bitmapSize = header->maxRecords / 8 + 1;
-   memcpy(bitmap, read(buf, page, sizeof(HeapPageHeader), bitmapSize), bitmapSize);
+   memcpy(bitmap, span.data() + sizeof(HeapPageHeader), header->maxRecords / 8 + 1);
    return 0;
 }
 
-int pHGetNextPage(Buffer *buf, DiskAddress page, DiskAddress *nextPage) {
-   HeapPageHeader *header = getPageHeader(buf, page);
+int pHGetNextPage(Buffer *buf, DiskAddress page, DiskAddress *nextPage,
+ BufferRing *ring) {
+   PageSpan span(buf, page, 0, sizeof(HeapPageHeader), ring);
+   const HeapPageHeader *header = pageHeader(span);
    if (!header)
       return -1;
 
@@ -420,18 +600,9 @@ int pHGetNextPage(Buffer *buf, DiskAddress page, DiskAddress *nextPage) {
    return 0;
 }
 
-int pHGetNextFree(Buffer *buf, DiskAddress page, DiskAddress *nextPage) {
-   HeapPageHeader *header = getPageHeader(buf, page);
-   if (!header)
-      return -1;
-
-   nextPage->FD = page.FD;
-   nextPage->pageId = header->nextFree;
-   return 0;
-}
-
 int pHGetPrevPage(Buffer *buf, DiskAddress page, DiskAddress *prevPage) {
-   HeapPageHeader *header = getPageHeader(buf, page);
+   PageSpan span(buf, page, 0, sizeof(HeapPageHeader));
+   const HeapPageHeader *header = pageHeader(span);
    if (!header)
       return -1;
 
@@ -441,72 +612,61 @@ int pHGetPrevPage(Buffer *buf, DiskAddress page, DiskAddress *prevPage) {
 }
 
 int pHSetNextPage(Buffer *buf, DiskAddress page, int nextPage) {
-   HeapPageHeader *header = getPageHeader(buf, page);
+   PageEdit edit(buf, page, 0, sizeof(HeapPageHeader));
+   HeapPageHeader *header = pageHeader(edit);
    if (!header)
       return -1;
 
    header->nextPage = nextPage;
-   return write(buf, page, 0, sizeof(HeapPageHeader), (char *)header, sizeof(HeapPageHeader));
+   return 0;
 }
 
 int pHSetPrevPage(Buffer *buf, DiskAddress page, int prevPage) {
-   HeapPageHeader *header = getPageHeader(buf, page);
+   PageEdit edit(buf, page, 0, sizeof(HeapPageHeader));
+   HeapPageHeader *header = pageHeader(edit);
    if (!header)
       return -1;
 
    header->prevPage = prevPage;
-   return write(buf, page, 0, sizeof(HeapPageHeader), (char *)header, sizeof(HeapPageHeader));
-}
-
-int pHSetNextFree(Buffer *buf, DiskAddress page, int nextFree) {
-   HeapPageHeader *header = getPageHeader(buf, page);
-   if (!header)
-      return -1;
-
-   header->nextFree = nextFree;
-   return write(buf, page, 0, sizeof(HeapPageHeader), (char *)header, sizeof(HeapPageHeader));
+   return 0;
 }
 
 int pHSetBitmapTrue(Buffer *buf, DiskAddress page, int index) {
-   HeapPageHeader *header = getPageHeader(buf, page);
-   if (!header)
+   PageEdit edit(buf, page, sizeof(HeapPageHeader) + index / 8, 1);
+   if (!edit.valid())
       return -1;
 
-   int bitmapSize = header->maxRecords / 8 + 1;
-   char *bitmap = read(buf, page, sizeof(HeapPageHeader), bitmapSize);
-   bitmap[index / 8] |= 0x80 >> (index % 8);
-
-   return write(buf, page, sizeof(HeapPageHeader), bitmapSize, bitmap, bitmapSize);
+   bitmapSet(edit.data(), index % 8);
+   return 0;
 }
 
 int pHSetBitmapFalse(Buffer *buf, DiskAddress page, int index) {
-   HeapPageHeader *header = getPageHeader(buf, page);
-   if (!header)
+   PageEdit edit(buf, page, sizeof(HeapPageHeader) + index / 8, 1);
+   if (!edit.valid())
       return -1;
 
-   int bitmapSize = header->maxRecords / 8 + 1;
-   char *bitmap = read(buf, page, sizeof(HeapPageHeader), bitmapSize);
-   bitmap[index / 8] &= ~(0x80 >> (index % 8));
-
-   return write(buf, page, sizeof(HeapPageHeader), bitmapSize, bitmap, bitmapSize);
+   bitmapClear(edit.data(), index % 8);
+   return 0;
 }
 
 int pHDecrementNumRecords(Buffer *buf, DiskAddress page) {
-   HeapPageHeader *header = getPageHeader(buf, page);
+   PageEdit edit(buf, page, 0, sizeof(HeapPageHeader));
+   HeapPageHeader *header = pageHeader(edit);
    if (!header)
       return -1;
 
    header->occupied--;
-   return write(buf, page, 0, sizeof(HeapPageHeader), (char *)header, sizeof(HeapPageHeader));
+   return 0;
 }
 
 int pHIncrementNumRecords(Buffer *buf, DiskAddress page) {
-   HeapPageHeader *header = getPageHeader(buf, page);
+   PageEdit edit(buf, page, 0, sizeof(HeapPageHeader));
+   HeapPageHeader *header = pageHeader(edit);
    if (!header)
       return -1;
 
    header->occupied++;
-   return write(buf, page, 0, sizeof(HeapPageHeader), (char *)header, sizeof(HeapPageHeader));
+   return 0;
 }
 
 int getField(char *fieldName, char *record, RecordDesc rd, char *out) {
@@ -539,111 +699,411 @@ int setField(char *fieldName, char *record, RecordDesc rd, char *value) {
    return -1;
 }
 
-int insertRecord(Buffer *buf, char *tableName, char *record, DiskAddress *location) {
-   DiskAddress page;
+// The free-space map: 4 bits per page of a heap file, on map pages of their
+// own (see FreeMapHeader) that are added as the file grows and are not on its
+// page list. It is only a hint. insertRecord marks a page it finds full and
+// looks again, so the map may lag behind the pages.
 
-   int fd = getFd(tableName);
+// how many pages one map page keeps
+static int freeMapCapacity() {
+   return (BLOCKSIZE - (int)sizeof(FreeMapHeader)) * 2;
+}
 
-   if (heapHeaderGetFreeSpace(buf, fd, &page) < 0)
-      return -1;
+// the level kept for a page with free of its maxRecords slots free, 0 only
+// for a full page
+static int freeLevel(int free, int maxRecords) {
+   if (free <= 0)
+      return 0;
 
-   int recordSize;
-   if (page.pageId == -1) { // make a new page
-      newPage(buf, page.FD, &page);
+   int level = free * FREE_LEVELS / maxRecords;
+   return level ? level : 1;
+}
 
-      HeapPageHeader header;
-      strcpy(header.filename, tableName);
-      header.pageId = page.pageId;
+// the fewest free slots a page kept at level can have
+static int levelMinFree(int level, int maxRecords) {
+   return level <= 1 ? level : (level * maxRecords + FREE_LEVELS - 1) / FREE_LEVELS;
+}
 
-      heapHeaderGetRecordSize(buf, fd, &recordSize);
-      header.maxRecords = (BLOCKSIZE - PAGE_HDR_SIZE) / recordSize;
+// Reads the page ids of fd's map pages the first time file is used.
+static void loadFreeMap(Buffer *buf, int fd, HeapFile *file) {
+   if (file->mapLoaded)
+      return;
 
-      header.occupied = 0;
+   for (int map = file->header.freeMap; map; ) {
+      FreeMapHeader mapHeader;
+      file->freeMaps.push_back(map);
+      if (readInto(buf, DiskAddress{fd, map}, 0, sizeof(FreeMapHeader), (char *)&mapHeader) < 0)
+         break;
+      map = mapHeader.nextMap;
+   }
+   file->mapLoaded = 1;
+}
 
-      // update linked list
+// Keeps pageId of fd at level, adding map pages when pageId is past the
+// last one's. Called with the HeapFileTable latch held.
+static int setFreeLevel(Buffer *buf, int fd, HeapFile *file, int pageId, int level) {
+   int map = pageId / freeMapCapacity(), entry = pageId % freeMapCapacity();
 
-      DiskAddress nextPage;
-      heapHeaderGetNextPage(buf, fd, &nextPage);
-      if (nextPage.pageId == -1)
-         heapHeaderSetNextPage(buf, fd, page.pageId);
+   while ((int)file->freeMaps.size() <= map) {
+      DiskAddress addr;
+      if (newPage(buf, fd, &addr) < 0)
+         return -1;
 
-      DiskAddress oldLastPage;
-      heapHeaderGetLastPage(buf, fd, &oldLastPage);
-      header.prevPage = oldLastPage.pageId;
-      header.nextPage = header.nextFree = -1;
-      heapHeaderSetLastPage(buf, fd, page.pageId);
+      if (file->freeMaps.empty()) {
+         if (markHeaderDirty(buf, fd, file) < 0)
+            return -1;
+         file->header.freeMap = addr.pageId;
+      }
+      else {
+         PageEdit last(buf, DiskAddress{fd, file->freeMaps.back()}, 0, sizeof(FreeMapHeader));
+         if (!last.valid())
+            return -1;
+         ((FreeMapHeader *)last.data())->nextMap = addr.pageId;
+      }
+      file->freeMaps.push_back(addr.pageId);
+   }
 
-      if (oldLastPage.pageId > 0)
-         pHSetNextPage(buf, oldLastPage, page.pageId);
+   PageEdit edit(buf, DiskAddress{fd, file->freeMaps[map]}, sizeof(FreeMapHeader) + entry / 2, 1);
+   if (!edit.valid())
+      return -1;
 
-      heapHeaderSetFreeSpace(buf, fd, page.pageId);
+   char *byte = edit.data();
+   if (entry % 2)
+      *byte = (*byte & 0xf0) | level;
+   else
+      *byte = (*byte & 0x0f) | level << 4;
 
-      writePersistent(buf, page, 0, sizeof(HeapPageHeader), (char *)&header, sizeof(HeapPageHeader));
+   if (level && pageId < file->freeHint)
+      file->freeHint = pageId;
+   return 0;
+}
 
-      heapHeaderIncrementNumBlocks(buf, fd);
+// The first page of fd kept at level or above, looking from the hint on and
+// then from the start. -1 if there is none. Runs of 16 full pages are
+// skipped a word at a time.
+static int findFreeLevel(Buffer *buf, int fd, HeapFile *file, int level) {
+   int capacity = freeMapCapacity(), total = file->freeMaps.size() * capacity;
+   int start = file->freeHint < total ? file->freeHint : 0;
+
+   for (int pass = 0; pass < 2; pass++) {
+      int from = pass ? 0 : start, to = pass ? start : total;
+
+      for (int map = from / capacity; map * capacity < to; map++) {
+         PageSpan span(buf, DiskAddress{fd, file->freeMaps[map]}, sizeof(FreeMapHeader), capacity / 2);
+         if (!span.valid())
+            return -1;
+
+         const unsigned char *entries = (const unsigned char *)span.data();
+         int first = map * capacity;
+         for (int i = from > first ? from - first : 0; i < capacity && first + i < to; ) {
+            uint64_t word = 1;
+            if (i % 16 == 0 && i + 16 <= capacity)
+               memcpy(&word, entries + i / 2, sizeof(word));
+            if (!word) {
+               i += 16;
+               continue;
+            }
+
+            int e = i % 2 ? entries[i / 2] & 0x0f : entries[i / 2] >> 4;
+            if (e >= level)
+               return first + i;
+            i++;
+         }
+      }
    }
+   return -1;
+}
 
-   int maxRecords;
-   pHGetMaxRecords(buf, page, &maxRecords);
-   char *bitmap = (char *)malloc(maxRecords / 8 + 1);
-   pHGetBitmap(buf, page, bitmap);
+// Gives a file made before free-space maps one, from its page headers. The
+// pages are read without the HeapFileTable latch, see HeapFileTable.
+static int buildFreeMap(Buffer *buf, int fd, DiskAddress page) {
+   vector<pair<int, int> > levels;
+
+   while (page.pageId != -1) {
+      int maxRecords, occupied;
+      if (pHGetMaxRecords(buf, page, &maxRecords) < 0 || pHGetNumRecords(buf, page, &occupied) < 0)
+         return -1;
+      levels.push_back(make_pair(page.pageId, freeLevel(maxRecords - occupied, maxRecords)));
+      pHGetNextPage(buf, page, &page);
+   }
 
-   int recordNdx;
-   for (recordNdx = 0; recordNdx < maxRecords; recordNdx++) {
-      if (!bitmapIsSet(bitmap, recordNdx))
-         break;
+   HeapFilesLock files(buf);
+   HeapFile *file = files.file(fd);
+   if (!file)
+      return -1;
+   if (file->header.freeMap) // someone else got here first
+      return 0;
+
+   loadFreeMap(buf, fd, file);
+   for (size_t i = 0; i < levels.size(); i++) {
+      if (setFreeLevel(buf, fd, file, levels[i].first, levels[i].second) < 0)
+         return -1;
    }
+   return 0;
+}
 
-   if (recordNdx == maxRecords)
+// Sets page to a page of fd with room for nRecords more records, going by
+// its free-space map, or page->pageId to -1 if no page has that much.
+int heapFindFreePage(Buffer *buf, int fd, int nRecords, DiskAddress *page) {
+   DiskAddress first;
+   page->FD = first.FD = fd;
+   {
+      HeapFilesLock files(buf);
+      HeapFile *file = files.file(fd);
+      if (!file)
+         return -1;
+
+      first.pageId = file->header.pageList;
+      if (file->header.freeMap || first.pageId == -1) {
+         loadFreeMap(buf, fd, file);
+
+         int maxRecords = pageMaxRecords(file->header.recordSize), level;
+         for (level = 1; level < FREE_LEVELS && levelMinFree(level, maxRecords) < nRecords; level++)
+            ;
+
+         page->pageId = findFreeLevel(buf, fd, file, level);
+         if (level == 1) // nothing between the old hint and here has room
+            file->freeHint = page->pageId == -1 ? file->freeMaps.size() * freeMapCapacity()
+             : page->pageId;
+         return 0;
+      }
+   }
+
+   if (buildFreeMap(buf, fd, first) < 0)
       return -1;
+   return heapFindFreePage(buf, fd, nRecords, page);
+}
 
-   *location = page;
+// Keeps the free-space map up to date with page having free of its
+// maxRecords slots free.
+static int noteFreeSpace(Buffer *buf, DiskAddress page, int free, int maxRecords) {
+   HeapFilesLock files(buf);
+   HeapFile *file = files.file(page.FD);
+   if (!file)
+      return -1;
+   // a file from before free-space maps gets one built when it is first
+   // needed, unless this is its first page
+   if (!file->header.freeMap && file->header.numBlocks > 1)
+      return 0;
+
+   loadFreeMap(buf, page.FD, file);
+   return setFreeLevel(buf, page.FD, file, page.pageId, freeLevel(free, maxRecords));
+}
+
+// Puts a new, empty page at the end of the file's page list.
+static int addHeapPage(Buffer *buf, char *tableName, int fd, int recordSize, DiskAddress *page) {
+   if (newPage(buf, fd, page) < 0)
+      return -1;
+
+   HeapPageHeader header;
+   strcpy(header.filename, tableName);
+   header.pageId = page->pageId;
+
+   header.maxRecords = pageMaxRecords(recordSize);
+
+   header.occupied = 0;
+
+   // update linked list
+
+   DiskAddress nextPage;
+   heapHeaderGetNextPage(buf, fd, &nextPage);
+   if (nextPage.pageId == -1)
+      heapHeaderSetNextPage(buf, fd, page->pageId);
+
+   DiskAddress oldLastPage;
+   heapHeaderGetLastPage(buf, fd, &oldLastPage);
+   header.prevPage = oldLastPage.pageId;
+   header.nextPage = header.nextFree = -1;
+   heapHeaderSetLastPage(buf, fd, page->pageId);
 
-   pHSetBitmapTrue(buf, page, recordNdx);
-   pHIncrementNumRecords(buf, page);
+   if (oldLastPage.pageId > 0)
+      pHSetNextPage(buf, oldLastPage, page->pageId);
+
+   writePersistent(buf, *page, 0, sizeof(HeapPageHeader), (char *)&header, sizeof(HeapPageHeader));
+
+   heapHeaderIncrementNumBlocks(buf, fd);
+   return noteFreeSpace(buf, *page, header.maxRecords, header.maxRecords);
+}
+
+int insertRecord(Buffer *buf, char *tableName, char *record, DiskAddress *location) {
+   DiskAddress page;
+
+   int fd = getFd(tableName);
+
+   int recordSize;
+   if (heapHeaderGetRecordSize(buf, fd, &recordSize) < 0)
+      return -1;
+
+   int recordNdx = -1;
+   while (recordNdx < 0) {
+      if (heapFindFreePage(buf, fd, 1, &page) < 0)
+         return -1;
+      if (page.pageId == -1 && addHeapPage(buf, tableName, fd, recordSize, &page) < 0)
+         return -1;
+
+      // Everything else happens on the one pinned page: find a free slot, mark
+      // it, bump the count and copy the record in.
+      int free, maxRecords;
+      {
+         PageGuard guard(buf, page, NULL, LATCH_EXCLUSIVE);
+         if (!guard.valid())
+            return -1;
+
+         HeapPageHeader *header = (HeapPageHeader *)guard.data();
+         char *bitmap = guard.data() + sizeof(HeapPageHeader);
+
+         recordNdx = bitmapNextClear(bitmap, 0, header->maxRecords);
+         if (recordNdx >= 0) {
+            bitmapSet(bitmap, recordNdx);
+            header->occupied++;
+            memcpy(guard.data() + pageHeaderSize(recordSize) + recordNdx * recordSize, record, recordSize);
+            guard.markDirty();
+         }
+         free = header->maxRecords - header->occupied;
+         maxRecords = header->maxRecords;
+      }
 
-   int x, y;
-   pHGetMaxRecords(buf, page, &x);
-   pHGetNumRecords(buf, page, &y);
-   if (x == y) { // page is now full
-      DiskAddress nextFree;
-      pHGetNextFree(buf, page, &nextFree);
-      heapHeaderSetFreeSpace(buf, fd, nextFree.pageId);
+      // a page the map had wrong is marked full and another one looked for
+      if (recordNdx < 0 || freeLevel(free + 1, maxRecords) != freeLevel(free, maxRecords)) {
+         if (noteFreeSpace(buf, page, free, maxRecords) < 0)
+            return -1;
+      }
    }
 
+   *location = page;
    heapHeaderIncrementNumTuples(buf, fd);
 
-   return putRecord(buf, page, recordNdx, record);  
+   return 0;
 }
 
 /* deleteRecord:
- * if page is full:
- *    put page at front of freelist
  * setBitmapFalse
  * decrementCount
+ * tell the free-space map if the page's level changed
  */
 int deleteRecord(Buffer *buf, DiskAddress page, int recordId) {
-   int x, y;
-   pHGetMaxRecords(buf, page, &x);
-   pHGetNumRecords(buf, page, &y);
-   if (x == y) { // page is now full, put at front of free list
-      // set this page's nextFree to file header's nextFree
-      DiskAddress z;
-      heapHeaderGetFreeSpace(buf, page.FD, &z);
-      pHSetNextFree(buf, page, z.pageId);
-      
-      // set file header's nextFree to this page
-      heapHeaderSetFreeSpace(buf, page.FD, page.pageId);
+   int free, maxRecords;
+   {
+      PageGuard guard(buf, page, NULL, LATCH_EXCLUSIVE);
+      if (!guard.valid())
+         return -1;
+
+      HeapPageHeader *header = (HeapPageHeader *)guard.data();
+      char *bitmap = guard.data() + sizeof(HeapPageHeader);
+
+      bitmapClear(bitmap, recordId);
+      header->occupied--;
+      guard.markDirty();
+
+      free = header->maxRecords - header->occupied;
+      maxRecords = header->maxRecords;
    }
 
-   pHSetBitmapFalse(buf, page, recordId);
-   pHDecrementNumRecords(buf, page);
+   if (freeLevel(free - 1, maxRecords) != freeLevel(free, maxRecords))
+      noteFreeSpace(buf, page, free, maxRecords);
 
    heapHeaderDecrementNumTuples(buf, page.FD);
 
    return 0;
 }
 
+HeapWriter::HeapWriter(Buffer *buf, char *tableName)
+ : buf(buf), tableName(tableName), fd(getFd(tableName)), recordSize(-1), guard(NULL), added(0),
+ failed(0) {
+   heapHeaderGetRecordSize(buf, fd, &recordSize);
+}
+
+// Only a caller that did not flush() leaves work for here, so a failure is
+// reported rather than lost.
+HeapWriter::~HeapWriter() {
+   if ((guard || failed) && flush() < 0)
+      fprintf(stderr, "HeapWriter: records for %s were not all written\n", tableName);
+}
+
+// Pins a page with room for records, a new one at the end of the file if
+// the free-space map knows of none, and marks it full in the map so inserts
+// look elsewhere while it is being filled. An insert that picked it earlier
+// may still take slots of it, see append().
+int HeapWriter::startPage() {
+   maxRecords = pageMaxRecords(recordSize);
+   if (heapFindFreePage(buf, fd, 1, &page) < 0)
+      return -1;
+   if (page.pageId == -1 && addHeapPage(buf, tableName, fd, recordSize, &page) < 0)
+      return -1;
+   if (noteFreeSpace(buf, page, 0, maxRecords) < 0)
+      return -1;
+
+   guard = new PageGuard(buf, page);
+   if (!guard->valid()) {
+      delete guard;
+      guard = NULL;
+      return -1;
+   }
+   slot = 0;
+   added = 0;
+   return 0;
+}
+
+// Copies record into the next free slot of the page being filled, and marks
+// it taken there. The page is latched for each record only, and the slot is
+// looked for under the latch, so inserts into the same page and scans of
+// other pages by this thread go on meanwhile. A page with no free slot left
+// is finished with flush() and the record goes on the next one.
+int HeapWriter::append(char *record) {
+   while (1) {
+      if (recordSize < 0 || (!guard && startPage() < 0)) {
+         failed = 1;
+         return -1;
+      }
+
+      guard->latch(LATCH_EXCLUSIVE);
+      slot = bitmapNextClear(guard->data() + sizeof(HeapPageHeader), slot, maxRecords);
+      if (slot >= 0)
+         break;
+      guard->unlatch();
+      if (flush() < 0) {
+         failed = 1;
+         return -1;
+      }
+   }
+
+   HeapPageHeader *header = (HeapPageHeader *)guard->data();
+   char *bitmap = guard->data() + sizeof(HeapPageHeader);
+
+   memcpy(guard->data() + pageHeaderSize(recordSize) + slot * recordSize, record, recordSize);
+   bitmapSet(bitmap, slot);
+   header->occupied++;
+   slot++;
+   added++;
+
+   guard->unlatch();
+   return 0;
+}
+
+// Finishes the page being filled: marks it dirty, unpins it and sets its
+// level in the free-space map and the file's numTuples, once each. The next
+// append starts another page. Returns -1 if that fails or an append since
+// the last flush did.
+int HeapWriter::flush() {
+   int appendFailed = failed;
+   failed = 0;
+   if (!guard)
+      return appendFailed ? -1 : 0;
+
+   // a page append found no slot in counts as full, whatever its header says
+   guard->latch(LATCH_SHARED);
+   int free = slot < 0 ? 0 : maxRecords - ((HeapPageHeader *)guard->data())->occupied;
+   guard->unlatch();
+   guard->markDirty();
+   delete guard;
+   guard = NULL;
+
+   if (noteFreeSpace(buf, page, free, maxRecords) < 0 ||
+    heapHeaderAddNumTuples(buf, fd, added) < 0 || appendFailed)
+      return -1;
+   return 0;
+}
+
 int updateRecord(Buffer *buf, DiskAddress page, int recordId, char *record) {
    return putRecord(buf, page, recordId, record);
 }
@@ -654,3 +1114,72 @@ int bitmapIsSet(char *bitmap, int ndx) {
    return bitmap[ndx / 8] & mask;
 }
 
+void bitmapSet(char *bitmap, int ndx) {
+   bitmap[ndx / 8] |= 0x80 >> (ndx % 8);
+}
+
+void bitmapClear(char *bitmap, int ndx) {
+   bitmap[ndx / 8] &= ~(0x80 >> (ndx % 8));
+}
+
+// The 64 bits of bitmap from index word * 64 on, flipped if clear is set,
+// with index word * 64 in the top bit (the bitmap is most significant bit
+// first in each byte) and anything at nBits or past it zero.
+static inline uint64_t bitmapWord(const char *bitmap, int word, int nBits, bool clear) {
+   int first = word * 64, bits = nBits - first < 64 ? nBits - first : 64;
+   uint64_t w = 0;
+
+   memcpy(&w, bitmap + word * 8, (bits + 7) / 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+   w = __builtin_bswap64(w);
+#endif
+   if (clear)
+      w = ~w;
+   return bits == 64 ? w : w & ~(~0ULL >> bits);
+}
+
+// Returns the first index from from on below nBits whose bit is set (or
+// clear), -1 if there is none. Looks at 64 bits at a time.
+static int bitmapNext(const char *bitmap, int from, int nBits, bool clear) {
+   for (int word = from / 64; word * 64 < nBits; word++) {
+      uint64_t w = bitmapWord(bitmap, word, nBits, clear);
+      if (word == from / 64)
+         w &= ~0ULL >> (from % 64);
+      if (w)
+         return word * 64 + __builtin_clzll(w);
+   }
+   return -1;
+}
+
+int bitmapNextSet(const char *bitmap, int from, int nBits) {
+   return bitmapNext(bitmap, from, nBits, false);
+}
+
+int bitmapNextClear(const char *bitmap, int from, int nBits) {
+   return bitmapNext(bitmap, from, nBits, true);
+}
+
+// Fills slots with the indexes below nBits whose bit is set, in order, and
+// returns how many there are. slots needs room for nBits of them.
+int bitmapSelect(const char *bitmap, int nBits, int *slots) {
+   int n = 0;
+   for (int word = 0; word * 64 < nBits; word++) {
+      uint64_t w = bitmapWord(bitmap, word, nBits, false);
+      int count = __builtin_popcountll(w);
+
+      if (count == 64) { // a full word needs no searching
+         for (int i = 0; i < 64; i++)
+            slots[n + i] = word * 64 + i;
+      }
+      else {
+         for (int i = 0; i < count; i++) {
+            int bit = __builtin_clzll(w);
+            slots[n + i] = word * 64 + bit;
+            w &= ~(0x8000000000000000ULL >> bit);
+         }
+      }
+      n += count;
+   }
+   return n;
+}
+
@@ -3,9 +3,12 @@
 
 #define NAME_LEN 30
 #define MAX_FIELDS 40
-#define PAGE_HDR_SIZE 256
+#define PAGE_HDR_SIZE 256 // of DEFAULT_BLOCKSIZE pages, see pageHeaderSize()
+#define FREE_LEVELS 15 // a page's free space is kept as 0 (full) to FREE_LEVELS
 
 #include <vector>
+#include <mutex>
+#include <unordered_map>
 #include "bufferManager.h"
 #include "FLOPPY_statements/FLOPPYPrimaryKey.h"
 #include "FLOPPY_statements/FLOPPYForeignKey.h"
@@ -28,11 +31,13 @@ typedef struct {
    int recordSize;
    int pageList; // page id of first page in file
    int lastPage;
-   int freeList; // page id of first page with free space
+   int freeList; // unused, pages with room are found through freeMap
    int numBlocks;
    int numTuples;
    RecordDesc recordDesc;
    int isVolatile;
+   int freeMap; // page id of the first free-space map page, 0 until there is one
+   int open; // set on disk while the copy in memory may be ahead of it
 } HeapFileHeader;
 
 typedef struct {
@@ -42,44 +47,72 @@ typedef struct {
    int occupied;
    int nextPage; // page id of next page in file
    int prevPage;
-   int nextFree; // page id of next page with free space
+   int nextFree; // unused, see HeapFileHeader.freeMap
 } HeapPageHeader;
 
+// Starts each page of a heap file's free-space map. The rest of the page
+// holds 4 bits per page of the file, two to a byte with the lower page id in
+// the high half, telling how much room the page has (see freeLevel()).
+typedef struct {
+   int nextMap; // page id of the next map page, 0 at the last
+} FreeMapHeader;
+
+// A heap file's header as kept in memory, see openHeapFiles()
+typedef struct {
+   HeapFileHeader header;
+   int dirty; // changed since it was last put on page 0
+   int mapLoaded; // freeMaps has been read from the file
+   vector<int> freeMaps; // page ids of the free-space map pages, in order
+   int freeHint; // no page before this one has room for a record
+} HeapFile;
+
+typedef struct {
+   std::mutex latch; // guards files, only latches of page 0 and of the
+                     // free-space map pages are taken under it, and those
+                     // of the heap pages while a header is recovered
+   std::unordered_map<int, HeapFile> files; // fd -> its header
+} HeapFileTable;
+
 int sizeOfRecordDesc(RecordDesc recordDesc);
+int pageHeaderSize(int recordSize);
+int pageMaxRecords(int recordSize);
 
 int createHeapFile(Buffer *buf, char *filename, RecordDesc recordDesc, int isVolatile,
  FLOPPYPrimaryKey *pk, vector<FLOPPYForeignKey *> *fk);
 int deleteHeapFile(Buffer *buf, char *tableName);
+void openHeapFiles(Buffer *buf);
+void closeHeapFiles(Buffer *buf);
 void getKeys(Buffer *buf, int fd, FLOPPYPrimaryKey *pk, vector<FLOPPYForeignKey *> *fks);
 
 int heapHeaderGetTableName(Buffer *buf, int fd, char *name);
 int heapHeaderGetRecordDesc(Buffer *buf, int fd, RecordDesc *recordDesc);
 int heapHeaderGetNextPage(Buffer *buf, int fd, DiskAddress *page);
 int heapHeaderGetLastPage(Buffer *buf, int fd, DiskAddress *page);
-int heapHeaderGetFreeSpace(Buffer *buf, int fd, DiskAddress *page);
 int heapHeaderGetRecordSize(Buffer *buf, int fd, int *recordSize);
 int heapHeaderGetNumBlocks(Buffer *buf, int fd, int *numBlocks);
 int heapHeaderGetNumTuples(Buffer *buf, int fd, int *numTuples);
 int heapHeaderIsVolatile(Buffer *buf, int fd, int *isVolatile);
 int heapHeaderIncrementNumBlocks(Buffer *buf, int fd);
 int heapHeaderIncrementNumTuples(Buffer *buf, int fd);
+int heapHeaderAddNumTuples(Buffer *buf, int fd, int n);
 int heapHeaderDecrementNumTuples(Buffer *buf, int fd);
 
 int heapHeaderSetNextPage(Buffer *buf, fileDescriptor fd, int nextPage);
 int heapHeaderSetLastPage(Buffer *buf, fileDescriptor fd, int lastPage);
-int heapHeaderSetFreeSpace(Buffer *buf, fileDescriptor fd, int freePage);
+int heapFindFreePage(Buffer *buf, int fd, int nRecords, DiskAddress *page);
 
-int getRecord(Buffer *buf, DiskAddress page, int recordId, char *bytes);
+int getRecord(Buffer *buf, DiskAddress page, int recordId, char *bytes,
+ BufferRing *ring = NULL);
 int putRecord(Buffer *buf, DiskAddress page, int recordId, char *bytes);
 
 int pHGetMaxRecords(Buffer *buf, DiskAddress page, int *maxRecords);
 int pHGetNumRecords(Buffer *buf, DiskAddress page, int *numRecords);
-int pHGetBitmap(Buffer *buf, DiskAddress page, char *bitmap);
-int pHGetNextPage(Buffer *buf, DiskAddress page, DiskAddress *nextPage);
-int pHGetNextFree(Buffer *buf, DiskAddress page, DiskAddress *nextPage);
+int pHGetBitmap(Buffer *buf, DiskAddress page, char *bitmap, BufferRing *ring = NULL);
+int pHGetNextPage(Buffer *buf, DiskAddress page, DiskAddress *nextPage,
+ BufferRing *ring = NULL);
 int pHGetPrevPage(Buffer *buf, DiskAddress page, DiskAddress *prevPage);
+int pHSetNextPage(Buffer *buf, DiskAddress page, int nextPage);
 int pHSetPrevPage(Buffer *buf, DiskAddress page, int prevPage);
-int pHSetNextFree(Buffer *buf, DiskAddress page, int nextFree);
 int pHSetBitmapTrue(Buffer *buf, DiskAddress page, int index);
 int pHSetBitmapFalse(Buffer *buf, DiskAddress page, int index);
 int pHDecrementNumRecords(Buffer *buf, DiskAddress page);
@@ -92,6 +125,42 @@ int insertRecord(Buffer *buf, char *tableName, char *record, DiskAddress *locati
 int deleteRecord(Buffer *buf, DiskAddress page, int recordId);
 int updateRecord(Buffer *buf, DiskAddress page, int recordId, char *record);
 
+// Appends records to a heap file a page at a time. The page being filled
+// stays pinned and its free slots are filled in order. Its free-space map
+// entry and the file's numTuples are updated once when it is done with (see
+// flush()). Callers flush() when done and check it, an append that failed
+// shows up there too. One HeapWriter per file at a time.
+class HeapWriter {
+public:
+   HeapWriter(Buffer *buf, char *tableName);
+   ~HeapWriter();
+
+   int append(char *record);
+   int flush();
+
+private:
+   HeapWriter(const HeapWriter &) = delete;
+   HeapWriter &operator=(const HeapWriter &) = delete;
+
+   int startPage();
+
+   Buffer *buf;
+   char *tableName;
+   int fd;
+   int recordSize;
+   DiskAddress page;
+   PageGuard *guard; // pins page, NULL between pages
+   int maxRecords;
+   int slot; // where to look for the next free slot of page
+   int added; // records appended to page
+   int failed; // an append went wrong since the last flush
+};
+
 int bitmapIsSet(char *bitmap, int ndx);
+void bitmapSet(char *bitmap, int ndx);
+void bitmapClear(char *bitmap, int ndx);
+int bitmapNextSet(const char *bitmap, int from, int nBits);
+int bitmapNextClear(const char *bitmap, int from, int nBits);
+int bitmapSelect(const char *bitmap, int nBits, int *slots);
 
 #endif
\ No newline at end of file
@@ -1685,13 +1685,25 @@ case 62:
 YY_RULE_SETUP
 #line 121 "FLOPPY_lexer.l"
 {
+                           /* keywords looked up here instead of having rules
+                            * of their own, so adding one needs no new tables */
+                           static const struct { const char *word; int token; } keywords[] = {
+                              { "SHOW", FLOPPY_SHOW },
+                              { "BUFFER", FLOPPY_BUFFER },
+                              { "STATS", FLOPPY_STATS },
+                              { "SIZE", FLOPPY_SIZE }
+                           };
+                           for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++) {
+                              if (!strcasecmp(yytext, keywords[i].word))
+                                 return keywords[i].token;
+                           }
                            yylval->sval = strdup(yytext);
                            return FLOPPY_ID;
                         }
 	YY_BREAK
 case 63:
 YY_RULE_SETUP
-#line 127 "FLOPPY_lexer.l"
+#line 139 "FLOPPY_lexer.l"
 { 
                            fprintf(stderr, "FLOPPY Lex Error Unknown Token: %c\n", yytext[0]); 
                            return 0;
@@ -1699,10 +1711,10 @@ YY_RULE_SETUP
 	YY_BREAK
 case 64:
 YY_RULE_SETUP
-#line 131 "FLOPPY_lexer.l"
+#line 143 "FLOPPY_lexer.l"
 ECHO;
 	YY_BREAK
-#line 1706 "FLOPPY_lexer.cpp"
+#line 1718 "FLOPPY_lexer.cpp"
 case YY_STATE_EOF(INITIAL):
 case YY_STATE_EOF(COMMENT):
 case YY_STATE_EOF(BLOCKCOMMENT):
@@ -2841,7 +2853,7 @@ void yyfree (void * ptr , yyscan_t yyscanner)
 
 #define YYTABLES_NAME "yytables"
 
-#line 131 "FLOPPY_lexer.l"
+#line 143 "FLOPPY_lexer.l"
 
 
 int yyerror(const char *errmsg) {
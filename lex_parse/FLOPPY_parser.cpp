@@ -182,7 +182,11 @@ typedef void* yyscan_t;
     FLOPPY_FLOAT = 305,
     FLOPPY_BOOLEAN = 306,
     FLOPPY_DATETIME = 307,
-    FLOPPY_VARCHAR = 308
+    FLOPPY_VARCHAR = 308,
+    FLOPPY_SHOW = 309,
+    FLOPPY_BUFFER = 310,
+    FLOPPY_STATS = 311,
+    FLOPPY_SIZE = 312
   };
 #endif
 
@@ -207,6 +211,8 @@ union YYSTYPE
    FLOPPYDeleteStatement *delete_statement;
    FLOPPYUpdateStatement *update_statement;
    FLOPPYSelectStatement *select_statement;
+   FLOPPYShowBufferStatsStatement *show_buffer_stats_statement;
+   FLOPPYSetBufferSizeStatement *set_buffer_size_statement;
    FLOPPYForeignKey *foreign_key;
    FLOPPYSelectItem *select_item;
    FLOPPYTableSpec *table_spec;
@@ -228,7 +234,7 @@ union YYSTYPE
    FLOPPYValue *value;
    FLOPPYNode *node;
 
-#line 232 "FLOPPY_parser.cpp" /* yacc.c:355  */
+#line 238 "FLOPPY_parser.cpp" /* yacc.c:355  */
 };
 
 typedef union YYSTYPE YYSTYPE;
@@ -258,7 +264,7 @@ int yyparse (FLOPPYOutput** result, yyscan_t scanner);
 
 /* Copy the second part of user declarations.  */
 
-#line 262 "FLOPPY_parser.cpp" /* yacc.c:358  */
+#line 268 "FLOPPY_parser.cpp" /* yacc.c:358  */
 
 #ifdef short
 # undef short
@@ -500,23 +506,23 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  26
+#define YYFINAL  32
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   252
+#define YYLAST   261
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  66
+#define YYNTOKENS  70
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  43
+#define YYNNTS  45
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  110
+#define YYNRULES  114
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  234
+#define YYNSTATES  243
 
 /* YYTRANSLATE[YYX] -- Symbol number corresponding to YYX as returned
    by yylex, with out-of-bounds checking.  */
 #define YYUNDEFTOK  2
-#define YYMAXUTOK   308
+#define YYMAXUTOK   312
 
 #define YYTRANSLATE(YYX)                                                \
   ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
@@ -529,9 +535,9 @@ static const yytype_uint8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-      61,    62,    59,    57,    65,    58,    63,    60,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,    64,
-      56,    54,    55,     2,     2,     2,     2,     2,     2,     2,
+      65,    66,    63,    61,    69,    62,    67,    64,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,    68,
+      60,    58,    59,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -555,25 +561,26 @@ static const yytype_uint8 yytranslate[] =
       15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
       25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
       35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
-      45,    46,    47,    48,    49,    50,    51,    52,    53
+      45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
+      55,    56,    57
 };
 
 #if YYDEBUG
   /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_uint16 yyrline[] =
 {
-       0,   142,   142,   149,   150,   151,   152,   153,   154,   155,
-     156,   169,   184,   188,   197,   201,   209,   213,   220,   224,
-     231,   240,   244,   251,   258,   262,   268,   276,   279,   282,
-     285,   288,   294,   297,   302,   313,   325,   338,   351,   360,
-     364,   371,   372,   376,   383,   387,   391,   395,   399,   411,
-     420,   421,   427,   432,   440,   446,   452,   458,   464,   470,
-     476,   481,   489,   490,   496,   502,   508,   514,   520,   528,
-     533,   537,   543,   549,   555,   561,   567,   581,   603,   621,
-     625,   628,   632,   639,   643,   649,   655,   661,   667,   673,
-     681,   685,   692,   697,   702,   710,   711,   715,   718,   724,
-     730,   736,   739,   745,   748,   754,   757,   763,   767,   774,
-     779
+       0,   147,   147,   154,   155,   156,   157,   158,   159,   160,
+     161,   162,   163,   176,   191,   195,   204,   208,   216,   220,
+     227,   231,   238,   247,   251,   258,   265,   269,   275,   283,
+     286,   289,   292,   295,   301,   304,   309,   320,   332,   345,
+     358,   367,   371,   378,   379,   383,   390,   394,   398,   402,
+     406,   418,   427,   428,   434,   439,   447,   453,   459,   465,
+     471,   477,   483,   488,   496,   497,   503,   509,   515,   521,
+     527,   535,   540,   544,   550,   556,   562,   568,   574,   588,
+     604,   614,   631,   649,   653,   656,   660,   667,   671,   677,
+     683,   689,   695,   701,   709,   713,   720,   725,   730,   738,
+     739,   743,   746,   752,   758,   764,   767,   773,   776,   782,
+     785,   791,   795,   802,   807
 };
 #endif
 
@@ -588,16 +595,18 @@ static const char *const yytname[] =
   "INSERT", "SELECT", "FROM", "WHERE", "UPDATE", "SET", "GROUP", "BY",
   "HAVING", "ORDER", "LIMIT", "DISTINCT", "COUNT", "AVERAGE", "MAX", "MIN",
   "SUM", "NULL", "AS", "NOT", "MOD", "LE", "GE", "NE", "TRUE", "FALSE",
-  "AND", "INT", "FLOAT", "BOOLEAN", "DATETIME", "VARCHAR", "'='", "'>'",
-  "'<'", "'+'", "'-'", "'*'", "'/'", "'('", "')'", "'.'", "';'", "','",
-  "$accept", "input", "statement", "create_table_statement",
-  "opt_volatile", "opt_index_only", "opt_split", "column_def_commalist",
-  "column_def", "attribute_list", "primary_key", "opt_foreign_key_list",
-  "foreign_key", "column_type", "opt_column_size", "int_literal",
-  "drop_table_statement", "create_index_statement", "drop_index_statement",
-  "insert_statement", "value_list", "value", "constant",
-  "delete_statement", "condition", "atomic_condition", "expression",
-  "atomic_expression", "update_statement", "select_statement",
+  "AND", "INT", "FLOAT", "BOOLEAN", "DATETIME", "VARCHAR", "SHOW",
+  "BUFFER", "STATS", "SIZE", "'='", "'>'", "'<'", "'+'", "'-'", "'*'",
+  "'/'", "'('", "')'", "'.'", "';'", "','", "$accept", "input",
+  "statement", "create_table_statement", "opt_volatile", "opt_index_only",
+  "opt_split", "column_def_commalist", "column_def", "attribute_list",
+  "primary_key", "opt_foreign_key_list", "foreign_key", "column_type",
+  "opt_column_size", "int_literal", "drop_table_statement",
+  "create_index_statement", "drop_index_statement", "insert_statement",
+  "value_list", "value", "constant", "delete_statement", "condition",
+  "atomic_condition", "expression", "atomic_expression",
+  "update_statement", "show_buffer_stats_statement",
+  "set_buffer_size_statement", "select_statement",
   "star_or_select_item_list", "select_item_list", "select_item",
   "table_spec_list", "table_spec", "opt_distinct", "opt_where",
   "opt_group_by", "opt_having", "opt_order_by", "opt_limit",
@@ -615,15 +624,15 @@ static const yytype_uint16 yytoknum[] =
      275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
      285,   286,   287,   288,   289,   290,   291,   292,   293,   294,
      295,   296,   297,   298,   299,   300,   301,   302,   303,   304,
-     305,   306,   307,   308,    61,    62,    60,    43,    45,    42,
-      47,    40,    41,    46,    59,    44
+     305,   306,   307,   308,   309,   310,   311,   312,    61,    62,
+      60,    43,    45,    42,    47,    40,    41,    46,    59,    44
 };
 # endif
 
-#define YYPACT_NINF -204
+#define YYPACT_NINF -203
 
 #define yypact_value_is_default(Yystate) \
-  (!!((Yystate) == (-204)))
+  (!!((Yystate) == (-203)))
 
 #define YYTABLE_NINF -1
 
@@ -634,30 +643,31 @@ static const yytype_uint16 yytoknum[] =
      STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-     128,    -4,    -1,   -16,    -7,   -17,    35,    80,    25,  -204,
-    -204,  -204,  -204,  -204,  -204,  -204,  -204,    78,    86,    95,
-      97,   137,   141,  -204,    61,    66,  -204,  -204,   109,   129,
-    -204,   130,    94,   132,    90,   103,   104,   116,   117,   119,
-    -204,   151,   118,  -204,  -204,   176,   120,   121,   179,   182,
-      24,   127,   184,    10,   185,   186,   187,   188,   190,    87,
-     142,   183,  -204,   193,   138,  -204,  -204,  -204,  -204,   139,
-     140,   143,   144,   145,  -204,    24,  -204,  -204,   199,    24,
-    -204,   155,  -204,   113,  -204,  -204,    28,  -204,   146,   147,
-     148,   149,   150,   152,    -2,     8,  -204,  -204,    18,   192,
-      88,   153,  -204,   208,    13,   210,   211,   212,   214,  -204,
-    -204,    39,    72,    24,    18,    18,    18,    18,    18,    18,
-      18,    18,    18,    18,    18,  -204,  -204,   -45,  -204,  -204,
-    -204,  -204,  -204,  -204,  -204,  -204,  -204,   215,    24,   190,
-     194,    18,    52,   156,  -204,  -204,  -204,  -204,  -204,   162,
-       4,  -204,    19,   163,   164,   165,   166,   167,   168,  -204,
-    -204,  -204,  -204,   102,   102,   102,   102,   102,   102,   -23,
-     -23,  -204,  -204,  -204,    28,  -204,   155,  -204,   195,   200,
-      46,    24,   216,  -204,   230,  -204,   222,  -204,  -204,  -204,
-     231,  -204,  -204,  -204,  -204,  -204,  -204,  -204,   232,   206,
-     207,   155,  -204,  -204,   178,   177,    71,  -204,    48,  -204,
-     232,   238,  -204,  -204,   208,  -204,   233,    24,   232,  -204,
-     180,  -204,   101,   234,  -204,   155,  -204,  -204,   181,   208,
-     114,   235,   242,  -204
+      -3,     8,    78,    -7,    14,    37,    30,    29,    40,   102,
+      35,  -203,  -203,  -203,  -203,  -203,  -203,  -203,  -203,  -203,
+    -203,   110,   123,   124,   138,   140,   149,  -203,    83,   137,
+     108,   111,  -203,  -203,   157,   150,  -203,   151,   145,   160,
+     104,   116,   117,   118,   119,   120,  -203,   162,   121,  -203,
+    -203,   182,   185,  -203,   125,   127,   184,   188,     7,   130,
+     191,     3,   192,   193,   195,   196,   197,    88,   146,  -203,
+     189,  -203,   200,   141,  -203,  -203,  -203,  -203,   142,   143,
+     144,   147,   148,  -203,     7,  -203,  -203,   207,     7,  -203,
+     163,  -203,   114,  -203,  -203,    52,  -203,   152,   153,   154,
+     155,   156,   158,    10,   -22,  -203,  -203,    25,   199,    60,
+     159,  -203,   210,     4,   211,   212,   218,   220,  -203,  -203,
+     -41,    89,     7,    25,    25,    25,    25,    25,    25,    25,
+      25,    25,    25,    25,  -203,  -203,   -32,  -203,  -203,  -203,
+    -203,  -203,  -203,  -203,  -203,  -203,   221,     7,   197,   201,
+      25,    43,   161,  -203,  -203,  -203,  -203,  -203,   166,    91,
+    -203,   -17,   167,   168,   169,   170,   171,   172,  -203,  -203,
+    -203,  -203,    99,    99,    99,    99,    99,    99,   -37,   -37,
+    -203,  -203,  -203,    52,  -203,   163,  -203,   198,   208,    74,
+       7,   216,  -203,   237,  -203,   229,  -203,  -203,  -203,   238,
+    -203,  -203,  -203,  -203,  -203,  -203,  -203,   239,   213,   214,
+     163,  -203,  -203,   179,   183,    28,  -203,     2,  -203,   239,
+     244,  -203,  -203,   210,  -203,   240,     7,   239,  -203,   180,
+    -203,    61,   241,  -203,   163,  -203,  -203,   187,   210,    73,
+     242,   245,  -203
 };
 
   /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -665,50 +675,51 @@ static const yytype_int16 yypact[] =
      means the default is an error.  */
 static const yytype_uint8 yydefact[] =
 {
-       0,     0,     0,     0,     0,    96,     0,     0,     0,     3,
-       4,     5,     6,     7,     8,     9,    10,     0,     0,     0,
-       0,     0,     0,    95,     0,     0,     1,     2,    13,     0,
-      35,     0,     0,     0,   109,     0,     0,     0,     0,     0,
-      79,     0,    80,    81,    83,     0,    15,     0,     0,     0,
+       0,     0,     0,     0,     0,   100,     0,     0,     0,     0,
+       0,     3,     4,     5,     6,     7,     8,     9,    11,    12,
+      10,     0,     0,     0,     0,     0,     0,    99,     0,     0,
+       0,     0,     1,     2,    15,     0,    37,     0,     0,     0,
+     113,     0,     0,     0,     0,     0,    83,     0,    84,    85,
+      87,     0,     0,    80,    17,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,    81,
+       0,    14,     0,     0,    39,    46,    48,    49,     0,     0,
+       0,     0,     0,    50,     0,    62,    63,     0,     0,    72,
+      51,    52,     0,    64,    71,     0,   114,     0,     0,     0,
+       0,     0,     0,    96,   102,    94,    86,     0,     0,     0,
+       0,    20,     0,     0,     0,     0,     0,     0,    54,    47,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,    12,     0,     0,    37,    44,    46,    47,     0,
-       0,     0,     0,     0,    48,     0,    60,    61,     0,     0,
-      70,    49,    50,     0,    62,    69,     0,   110,     0,     0,
-       0,     0,     0,     0,    92,    98,    90,    82,     0,     0,
-       0,     0,    18,     0,     0,     0,     0,     0,     0,    52,
-      45,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,    42,    43,     0,    39,    41,
-      84,    89,    85,    86,    87,    88,    93,     0,     0,     0,
-     100,     0,     0,    17,    27,    28,    31,    30,    29,    33,
-       0,    21,     0,     0,     0,     0,     0,     0,     0,    53,
-      68,    51,    67,    57,    58,    59,    56,    55,    54,    63,
-      64,    65,    66,    38,     0,    94,    97,    91,     0,   104,
-       0,     0,     0,    14,     0,    20,     0,    19,    25,    36,
-       0,    75,    76,    74,    72,    71,    73,    40,     0,     0,
-     106,    77,    16,    34,     0,     0,     0,    22,   102,   107,
-       0,     0,    78,    32,     0,    11,     0,     0,     0,    99,
-     103,   105,     0,     0,    24,   101,   108,    23,     0,     0,
-       0,     0,     0,    26
+       0,     0,     0,     0,    44,    45,     0,    41,    43,    88,
+      93,    89,    90,    91,    92,    97,     0,     0,     0,   104,
+       0,     0,    19,    29,    30,    33,    32,    31,    35,     0,
+      23,     0,     0,     0,     0,     0,     0,     0,    55,    70,
+      53,    69,    59,    60,    61,    58,    57,    56,    65,    66,
+      67,    68,    40,     0,    98,   101,    95,     0,   108,     0,
+       0,     0,    16,     0,    22,     0,    21,    27,    38,     0,
+      77,    78,    76,    74,    73,    75,    42,     0,     0,   110,
+      79,    18,    36,     0,     0,     0,    24,   106,   111,     0,
+       0,    82,    34,     0,    13,     0,     0,     0,   103,   107,
+     109,     0,     0,    26,   105,   112,    25,     0,     0,     0,
+       0,     0,    28
 };
 
   /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -204,  -204,  -204,  -204,  -204,  -204,  -204,  -204,    93,  -203,
-    -204,  -204,  -204,  -204,  -204,  -204,  -204,  -204,  -204,  -204,
-    -204,    75,   -84,  -204,   -74,  -204,   -73,  -204,  -204,  -204,
-    -204,  -204,   191,  -204,   112,  -204,  -204,  -204,  -204,  -204,
-    -204,    42,   -24
+    -203,  -203,  -203,  -203,  -203,  -203,  -203,  -203,    95,  -202,
+    -203,  -203,  -203,  -203,  -203,  -203,  -203,  -203,  -203,  -203,
+    -203,    75,   -94,  -203,   -82,  -203,   -50,  -203,  -203,  -203,
+    -203,  -203,  -203,  -203,   190,  -203,   112,  -203,  -203,  -203,
+    -203,  -203,  -203,    42,   -28
 };
 
   /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int16 yydefgoto[] =
 {
-      -1,     7,     8,     9,    47,    62,   183,   101,   102,   152,
-     188,   206,   224,   149,   185,   204,    10,    11,    12,    13,
-     127,   128,    80,    14,    81,    82,    83,    84,    15,    16,
-      41,    42,    43,    95,    96,    24,   140,   179,   219,   200,
-     212,   208,    85
+      -1,     9,    10,    11,    55,    71,   192,   110,   111,   161,
+     197,   215,   233,   158,   194,   213,    12,    13,    14,    15,
+     136,   137,    89,    16,    90,    91,    92,    93,    17,    18,
+      19,    20,    47,    48,    49,   104,   105,    28,   149,   188,
+     228,   209,   221,   217,    94
 };
 
   /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -716,126 +727,129 @@ static const yytype_int16 yydefgoto[] =
      number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_uint8 yytable[] =
 {
-      44,   109,   129,   136,    17,   111,   112,    19,    21,   100,
-      18,   222,    22,    20,   186,    88,    23,   173,   153,   114,
-     174,    66,    67,    34,    68,   142,   230,    66,    67,    34,
-      68,    66,    67,   138,    68,    44,   123,   124,   137,   161,
-      25,   162,   163,   164,   165,   166,   167,   168,   169,   170,
-     171,   172,    69,    70,    71,    72,    73,    74,    69,    70,
-      71,    72,    73,    74,   176,    75,    34,    74,   180,    89,
-      76,    77,   154,   139,   125,   126,    78,   181,   217,   141,
-      26,   189,    78,    28,   190,    79,    78,   113,   114,    27,
-     129,    29,    34,    45,   114,    35,    36,    37,    38,    39,
-      30,   159,    31,   121,   122,   123,   124,   201,   160,   121,
-     122,   123,   124,   218,   114,   115,   116,   117,    46,    50,
-      40,    35,    36,    37,    38,    39,   118,   119,   120,   121,
-     122,   123,   124,   215,   160,     1,   216,   144,   145,   146,
-     147,   148,    32,   225,   114,     2,    33,    48,    49,     3,
-       4,     5,    51,    52,     6,   114,   115,   116,   117,   121,
-     122,   123,   124,   227,    53,    54,   190,   118,   119,   120,
-     121,   122,   123,   124,   209,    58,   231,    55,    56,   190,
-      57,    60,    63,    59,    64,    61,   209,    65,    86,    87,
-      90,    91,    92,    93,   226,    94,    98,    99,   100,   103,
-     104,   105,   110,   113,   106,   107,   108,   143,   130,   131,
-     132,   133,   134,   151,   135,   155,   156,   157,   150,   158,
-     175,   182,   178,   184,   198,   191,   192,   193,   194,   195,
-     196,   199,   202,   203,   205,   210,   207,    34,   214,   211,
-     213,   221,   229,   187,   223,   218,   228,   233,   232,   197,
-      97,   177,   220
+      50,   138,   118,   147,     1,   123,   120,   122,    97,   162,
+      75,    76,    40,    77,     2,   145,    21,    25,     3,     4,
+       5,   231,    22,     6,     7,   168,   132,   133,    75,    76,
+      40,    77,   226,    26,   182,    29,   239,   183,   121,    50,
+     170,    78,    79,    80,    81,    82,    83,   148,    84,   198,
+     146,     8,   199,    85,    86,    75,    76,   151,    77,    78,
+      79,    80,    81,    82,    83,   185,    98,   163,   190,    87,
+      27,   227,    88,   171,   172,   173,   174,   175,   176,   177,
+     178,   179,   180,   181,    30,   123,    23,    87,    40,   138,
+     150,    83,    24,    40,   224,    31,   109,   225,   134,   135,
+     189,   195,    32,    33,   130,   131,   132,   133,   210,   153,
+     154,   155,   156,   157,    87,    34,   123,    41,    42,    43,
+      44,    45,    41,    42,    43,    44,    45,   236,    35,    36,
+     199,   123,   124,   125,   126,   130,   131,   132,   133,   240,
+     169,   123,   199,    37,   234,    38,    46,   127,   128,   129,
+     130,   131,   132,   133,    39,   169,   123,   124,   125,   126,
+     130,   131,   132,   133,    51,    52,    54,    53,    56,    57,
+      58,    60,   127,   128,   129,   130,   131,   132,   133,   218,
+      59,    61,    62,    63,    64,    65,    66,    68,    69,    73,
+      67,   218,    72,    74,    70,    95,    96,    99,   100,   235,
+     101,   102,   103,   108,   107,   109,   112,   113,   114,   115,
+     119,   122,   116,   117,   152,   160,   164,   165,   139,   140,
+     141,   142,   143,   166,   144,   167,   184,   207,   159,   187,
+     191,   193,   211,   200,   201,   202,   203,   204,   205,   208,
+     212,   214,   219,   216,    40,   222,   220,   230,   223,   227,
+     242,   232,   238,   237,   196,   241,     0,   106,   206,     0,
+     186,   229
 };
 
-static const yytype_uint8 yycheck[] =
+static const yytype_int16 yycheck[] =
 {
-      24,    75,    86,     5,     8,    79,    79,     8,    24,     5,
-      14,   214,    19,    14,    10,     5,    33,    62,     5,    42,
-      65,     3,     4,     5,     6,    98,   229,     3,     4,     5,
-       6,     3,     4,    25,     6,    59,    59,    60,    40,   113,
-       5,   114,   115,   116,   117,   118,   119,   120,   121,   122,
-     123,   124,    34,    35,    36,    37,    38,    39,    34,    35,
-      36,    37,    38,    39,   138,    41,     5,    39,   141,    59,
-      46,    47,    59,    65,    46,    47,    58,    25,    30,    61,
-       0,    62,    58,     5,    65,    61,    58,    48,    42,    64,
-     174,     5,     5,    27,    42,    34,    35,    36,    37,    38,
-       5,    62,     5,    57,    58,    59,    60,   181,    62,    57,
-      58,    59,    60,    65,    42,    43,    44,    45,     9,    25,
-      59,    34,    35,    36,    37,    38,    54,    55,    56,    57,
-      58,    59,    60,    62,    62,     7,    65,    49,    50,    51,
-      52,    53,     5,   217,    42,    17,     5,    18,    18,    21,
-      22,    23,    20,    63,    26,    42,    43,    44,    45,    57,
-      58,    59,    60,    62,    61,    61,    65,    54,    55,    56,
-      57,    58,    59,    60,   198,    24,    62,    61,    61,    65,
-      61,     5,    61,    65,     5,    65,   210,     5,    61,     5,
-       5,     5,     5,     5,   218,     5,    54,    14,     5,    61,
-      61,    61,     3,    48,    61,    61,    61,    15,    62,    62,
-      62,    62,    62,     5,    62,     5,     5,     5,    65,     5,
-       5,    65,    28,    61,    29,    62,    62,    62,    62,    62,
-      62,    31,    16,     3,    12,    29,     5,     5,    61,    32,
-      62,     3,    61,   150,    11,    65,    12,     5,    13,   174,
-      59,   139,   210
+      28,    95,    84,    25,     7,    42,    88,    48,     5,     5,
+       3,     4,     5,     6,    17,     5,     8,    24,    21,    22,
+      23,   223,    14,    26,    27,    66,    63,    64,     3,     4,
+       5,     6,    30,    19,    66,     5,   238,    69,    88,    67,
+     122,    34,    35,    36,    37,    38,    39,    69,    41,    66,
+      40,    54,    69,    46,    47,     3,     4,   107,     6,    34,
+      35,    36,    37,    38,    39,   147,    63,    63,    25,    62,
+      33,    69,    65,   123,   124,   125,   126,   127,   128,   129,
+     130,   131,   132,   133,    55,    42,     8,    62,     5,   183,
+      65,    39,    14,     5,    66,    55,     5,    69,    46,    47,
+     150,    10,     0,    68,    61,    62,    63,    64,   190,    49,
+      50,    51,    52,    53,    62,     5,    42,    34,    35,    36,
+      37,    38,    34,    35,    36,    37,    38,    66,     5,     5,
+      69,    42,    43,    44,    45,    61,    62,    63,    64,    66,
+      66,    42,    69,     5,   226,     5,    63,    58,    59,    60,
+      61,    62,    63,    64,     5,    66,    42,    43,    44,    45,
+      61,    62,    63,    64,    27,    57,     9,    56,    18,    18,
+      25,    67,    58,    59,    60,    61,    62,    63,    64,   207,
+      20,    65,    65,    65,    65,    65,    24,     5,     3,     5,
+      69,   219,    65,     5,    69,    65,     5,     5,     5,   227,
+       5,     5,     5,    14,    58,     5,    65,    65,    65,    65,
+       3,    48,    65,    65,    15,     5,     5,     5,    66,    66,
+      66,    66,    66,     5,    66,     5,     5,    29,    69,    28,
+      69,    65,    16,    66,    66,    66,    66,    66,    66,    31,
+       3,    12,    29,     5,     5,    66,    32,     3,    65,    69,
+       5,    11,    65,    12,   159,    13,    -1,    67,   183,    -1,
+     148,   219
 };
 
   /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
      symbol of state STATE-NUM.  */
 static const yytype_uint8 yystos[] =
 {
-       0,     7,    17,    21,    22,    23,    26,    67,    68,    69,
-      82,    83,    84,    85,    89,    94,    95,     8,    14,     8,
-      14,    24,    19,    33,   101,     5,     0,    64,     5,     5,
-       5,     5,     5,     5,     5,    34,    35,    36,    37,    38,
-      59,    96,    97,    98,   108,    27,     9,    70,    18,    18,
-      25,    20,    63,    61,    61,    61,    61,    61,    24,    65,
-       5,    65,    71,    61,     5,     5,     3,     4,     6,    34,
-      35,    36,    37,    38,    39,    41,    46,    47,    58,    61,
-      88,    90,    91,    92,    93,   108,    61,     5,     5,    59,
-       5,     5,     5,     5,     5,    99,   100,    98,    54,    14,
-       5,    73,    74,    61,    61,    61,    61,    61,    61,    90,
-       3,    90,    92,    48,    42,    43,    44,    45,    54,    55,
-      56,    57,    58,    59,    60,    46,    47,    86,    87,    88,
-      62,    62,    62,    62,    62,    62,     5,    40,    25,    65,
-     102,    61,    92,    15,    49,    50,    51,    52,    53,    79,
-      65,     5,    75,     5,    59,     5,     5,     5,     5,    62,
-      62,    90,    92,    92,    92,    92,    92,    92,    92,    92,
-      92,    92,    92,    62,    65,     5,    90,   100,    28,   103,
-      92,    25,    65,    72,    61,    80,    10,    74,    76,    62,
-      65,    62,    62,    62,    62,    62,    62,    87,    29,    31,
-     105,    90,    16,     3,    81,    12,    77,     5,   107,   108,
-      29,    32,   106,    62,    61,    62,    65,    30,    65,   104,
-     107,     3,    75,    11,    78,    90,   108,    62,    12,    61,
-      75,    62,    13,     5
+       0,     7,    17,    21,    22,    23,    26,    27,    54,    71,
+      72,    73,    86,    87,    88,    89,    93,    98,    99,   100,
+     101,     8,    14,     8,    14,    24,    19,    33,   107,     5,
+      55,    55,     0,    68,     5,     5,     5,     5,     5,     5,
+       5,    34,    35,    36,    37,    38,    63,   102,   103,   104,
+     114,    27,    57,    56,     9,    74,    18,    18,    25,    20,
+      67,    65,    65,    65,    65,    65,    24,    69,     5,     3,
+      69,    75,    65,     5,     5,     3,     4,     6,    34,    35,
+      36,    37,    38,    39,    41,    46,    47,    62,    65,    92,
+      94,    95,    96,    97,   114,    65,     5,     5,    63,     5,
+       5,     5,     5,     5,   105,   106,   104,    58,    14,     5,
+      77,    78,    65,    65,    65,    65,    65,    65,    94,     3,
+      94,    96,    48,    42,    43,    44,    45,    58,    59,    60,
+      61,    62,    63,    64,    46,    47,    90,    91,    92,    66,
+      66,    66,    66,    66,    66,     5,    40,    25,    69,   108,
+      65,    96,    15,    49,    50,    51,    52,    53,    83,    69,
+       5,    79,     5,    63,     5,     5,     5,     5,    66,    66,
+      94,    96,    96,    96,    96,    96,    96,    96,    96,    96,
+      96,    96,    66,    69,     5,    94,   106,    28,   109,    96,
+      25,    69,    76,    65,    84,    10,    78,    80,    66,    69,
+      66,    66,    66,    66,    66,    66,    91,    29,    31,   111,
+      94,    16,     3,    85,    12,    81,     5,   113,   114,    29,
+      32,   112,    66,    65,    66,    69,    30,    69,   110,   113,
+       3,    79,    11,    82,    94,   114,    66,    12,    65,    79,
+      66,    13,     5
 };
 
   /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
 static const yytype_uint8 yyr1[] =
 {
-       0,    66,    67,    68,    68,    68,    68,    68,    68,    68,
-      68,    69,    70,    70,    71,    71,    72,    72,    73,    73,
-      74,    75,    75,    76,    77,    77,    78,    79,    79,    79,
-      79,    79,    80,    80,    81,    82,    83,    84,    85,    86,
-      86,    87,    87,    87,    88,    88,    88,    88,    88,    89,
-      90,    90,    90,    90,    91,    91,    91,    91,    91,    91,
-      91,    91,    92,    92,    92,    92,    92,    92,    92,    93,
-      93,    93,    93,    93,    93,    93,    93,    94,    95,    96,
-      96,    97,    97,    98,    98,    98,    98,    98,    98,    98,
-      99,    99,   100,   100,   100,   101,   101,   102,   102,   103,
-     103,   104,   104,   105,   105,   106,   106,   107,   107,   108,
-     108
+       0,    70,    71,    72,    72,    72,    72,    72,    72,    72,
+      72,    72,    72,    73,    74,    74,    75,    75,    76,    76,
+      77,    77,    78,    79,    79,    80,    81,    81,    82,    83,
+      83,    83,    83,    83,    84,    84,    85,    86,    87,    88,
+      89,    90,    90,    91,    91,    91,    92,    92,    92,    92,
+      92,    93,    94,    94,    94,    94,    95,    95,    95,    95,
+      95,    95,    95,    95,    96,    96,    96,    96,    96,    96,
+      96,    97,    97,    97,    97,    97,    97,    97,    97,    98,
+      99,   100,   101,   102,   102,   103,   103,   104,   104,   104,
+     104,   104,   104,   104,   105,   105,   106,   106,   106,   107,
+     107,   108,   108,   109,   109,   110,   110,   111,   111,   112,
+     112,   113,   113,   114,   114
 };
 
   /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
 static const yytype_uint8 yyr2[] =
 {
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
-       1,    10,     2,     0,     4,     0,     2,     0,     1,     3,
-       3,     1,     3,     5,     3,     0,     7,     1,     1,     1,
-       1,     1,     3,     0,     1,     3,     8,     5,     7,     1,
-       3,     1,     1,     1,     1,     2,     1,     1,     1,     5,
-       1,     3,     2,     3,     3,     3,     3,     3,     3,     3,
-       1,     1,     1,     3,     3,     3,     3,     3,     3,     1,
-       1,     4,     4,     4,     4,     4,     4,     8,     9,     1,
-       1,     1,     3,     1,     4,     4,     4,     4,     4,     4,
-       1,     3,     1,     2,     3,     1,     0,     2,     0,     4,
-       0,     2,     0,     3,     0,     2,     0,     1,     3,     1,
-       3
+       1,     1,     1,    10,     2,     0,     4,     0,     2,     0,
+       1,     3,     3,     1,     3,     5,     3,     0,     7,     1,
+       1,     1,     1,     1,     3,     0,     1,     3,     8,     5,
+       7,     1,     3,     1,     1,     1,     1,     2,     1,     1,
+       1,     5,     1,     3,     2,     3,     3,     3,     3,     3,
+       3,     3,     1,     1,     1,     3,     3,     3,     3,     3,
+       3,     1,     1,     4,     4,     4,     4,     4,     4,     8,
+       3,     4,     9,     1,     1,     1,     3,     1,     4,     4,
+       4,     4,     4,     4,     1,     3,     1,     2,     3,     1,
+       0,     2,     0,     4,     0,     2,     0,     3,     0,     2,
+       0,     1,     3,     1,     3
 };
 
 
@@ -1615,64 +1629,76 @@ yyreduce:
   switch (yyn)
     {
         case 2:
-#line 142 "FLOPPY_parser.y" /* yacc.c:1661  */
+#line 147 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
       *result = new FLOPPYOutput((yyvsp[-1].statement)); 
       (*result)->isValid = true;
    }
-#line 1624 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1638 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
   case 3:
-#line 149 "FLOPPY_parser.y" /* yacc.c:1661  */
+#line 154 "FLOPPY_parser.y" /* yacc.c:1661  */
     { (yyval.statement) = (yyvsp[0].create_table_statement); }
-#line 1630 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1644 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
   case 4:
-#line 150 "FLOPPY_parser.y" /* yacc.c:1661  */
+#line 155 "FLOPPY_parser.y" /* yacc.c:1661  */
     { (yyval.statement) = (yyvsp[0].drop_table_statement); }
-#line 1636 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1650 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
   case 5:
-#line 151 "FLOPPY_parser.y" /* yacc.c:1661  */
+#line 156 "FLOPPY_parser.y" /* yacc.c:1661  */
     { (yyval.statement) = (yyvsp[0].create_index_statement); }
-#line 1642 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1656 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
   case 6:
-#line 152 "FLOPPY_parser.y" /* yacc.c:1661  */
+#line 157 "FLOPPY_parser.y" /* yacc.c:1661  */
     { (yyval.statement) = (yyvsp[0].drop_index_statement); }
-#line 1648 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1662 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
   case 7:
-#line 153 "FLOPPY_parser.y" /* yacc.c:1661  */
+#line 158 "FLOPPY_parser.y" /* yacc.c:1661  */
     { (yyval.statement) = (yyvsp[0].insert_statement); }
-#line 1654 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1668 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
   case 8:
-#line 154 "FLOPPY_parser.y" /* yacc.c:1661  */
+#line 159 "FLOPPY_parser.y" /* yacc.c:1661  */
     { (yyval.statement) = (yyvsp[0].delete_statement); }
-#line 1660 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1674 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
   case 9:
-#line 155 "FLOPPY_parser.y" /* yacc.c:1661  */
+#line 160 "FLOPPY_parser.y" /* yacc.c:1661  */
     { (yyval.statement) = (yyvsp[0].update_statement); }
-#line 1666 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1680 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
   case 10:
-#line 156 "FLOPPY_parser.y" /* yacc.c:1661  */
+#line 161 "FLOPPY_parser.y" /* yacc.c:1661  */
     { (yyval.statement) = (yyvsp[0].select_statement); }
-#line 1672 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1686 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
   case 11:
-#line 173 "FLOPPY_parser.y" /* yacc.c:1661  */
+#line 162 "FLOPPY_parser.y" /* yacc.c:1661  */
+    { (yyval.statement) = (yyvsp[0].show_buffer_stats_statement); }
+#line 1692 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+    break;
+
+  case 12:
+#line 163 "FLOPPY_parser.y" /* yacc.c:1661  */
+    { (yyval.statement) = (yyvsp[0].set_buffer_size_statement); }
+#line 1698 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+    break;
+
+  case 13:
+#line 180 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
                (yyval.create_table_statement) = new FLOPPYCreateTableStatement();
                (yyval.create_table_statement)->tableName = (yyvsp[-7].sval);
@@ -1681,630 +1707,630 @@ yyreduce:
                (yyval.create_table_statement)->pk = (yyvsp[-2].primary_key);
                (yyval.create_table_statement)->fk = (yyvsp[-1].foreign_key_vec);
             }
-#line 1685 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1711 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 12:
-#line 184 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 14:
+#line 191 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.flags) = (yyvsp[0].flags);
          (yyval.flags)->volatileFlag = true;
       }
-#line 1694 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1720 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 13:
-#line 188 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 15:
+#line 195 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.flags) = new CreateTableAdditionalFunctionality(); 
          (yyval.flags)->volatileFlag = false;
          (yyval.flags)->indexOnlyFlag = false;
          (yyval.flags)->splitFlag = false;
       }
-#line 1705 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1731 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 14:
-#line 197 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 16:
+#line 204 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.flags) = (yyvsp[0].flags);
          (yyval.flags)->indexOnlyFlag = true;
       }
-#line 1714 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1740 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 15:
-#line 201 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 17:
+#line 208 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.flags) = new CreateTableAdditionalFunctionality(); 
          (yyval.flags)->indexOnlyFlag = false;
          (yyval.flags)->splitFlag = false;
       }
-#line 1724 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1750 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 16:
-#line 209 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 18:
+#line 216 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.flags) = new CreateTableAdditionalFunctionality(); 
          (yyval.flags)->splitFlag = true;
       }
-#line 1733 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1759 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 17:
-#line 213 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 19:
+#line 220 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.flags) = new CreateTableAdditionalFunctionality(); 
          (yyval.flags)->splitFlag = false;
       }
-#line 1742 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1768 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 18:
-#line 220 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 20:
+#line 227 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.create_column_vec) = new std::vector<FLOPPYCreateColumn *>(); 
          (yyval.create_column_vec)->push_back((yyvsp[0].create_column)); 
       }
-#line 1751 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1777 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 19:
-#line 224 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 21:
+#line 231 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyvsp[-2].create_column_vec)->push_back((yyvsp[0].create_column));
          (yyval.create_column_vec) = (yyvsp[-2].create_column_vec);
       }
-#line 1760 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1786 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 20:
-#line 231 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 22:
+#line 238 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.create_column) = new FLOPPYCreateColumn();
          (yyval.create_column)->name = (yyvsp[-2].sval);
          (yyval.create_column)->type = (ColumnType) (yyvsp[-1].ival);
          (yyval.create_column)->size = (yyvsp[0].ival);
       }
-#line 1771 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1797 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 21:
-#line 240 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 23:
+#line 247 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.str_vec) = new std::vector<char *>(); 
          (yyval.str_vec)->push_back((yyvsp[0].sval)); 
       }
-#line 1780 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1806 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 22:
-#line 244 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 24:
+#line 251 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyvsp[-2].str_vec)->push_back((yyvsp[0].sval));
          (yyval.str_vec) = (yyvsp[-2].str_vec);
       }
-#line 1789 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1815 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 23:
-#line 251 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 25:
+#line 258 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.primary_key) = new FLOPPYPrimaryKey();
          (yyval.primary_key)->attributes = (yyvsp[-1].str_vec);
       }
-#line 1798 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1824 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 24:
-#line 258 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 26:
+#line 265 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.foreign_key_vec) = (yyvsp[-2].foreign_key_vec);
          (yyval.foreign_key_vec)->push_back((yyvsp[0].foreign_key));
       }
-#line 1807 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1833 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 25:
-#line 262 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 27:
+#line 269 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.foreign_key_vec) = new std::vector<FLOPPYForeignKey *>();
       }
-#line 1815 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1841 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 26:
-#line 268 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 28:
+#line 275 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.foreign_key) = new FLOPPYForeignKey();
          (yyval.foreign_key)->attributes = (yyvsp[-3].str_vec);
          (yyval.foreign_key)->refTableName = (yyvsp[0].sval);
       }
-#line 1825 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1851 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 27:
-#line 276 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 29:
+#line 283 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.ival) = ColumnType::INT; 
       }
-#line 1833 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1859 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 28:
-#line 279 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 30:
+#line 286 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.ival) = ColumnType::FLOAT; 
       }
-#line 1841 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1867 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 29:
-#line 282 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 31:
+#line 289 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.ival) = ColumnType::VARCHAR; 
       }
-#line 1849 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1875 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 30:
-#line 285 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 32:
+#line 292 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.ival) = ColumnType::DATETIME; 
       }
-#line 1857 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1883 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 31:
-#line 288 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 33:
+#line 295 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.ival) = ColumnType::BOOLEAN; 
       }
-#line 1865 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1891 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 32:
-#line 294 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 34:
+#line 301 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
       (yyval.ival) = (yyvsp[-1].ival); 
    }
-#line 1873 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1899 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 33:
-#line 297 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 35:
+#line 304 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
       (yyval.ival) = 0;
    }
-#line 1881 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1907 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 34:
-#line 302 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 36:
+#line 309 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.ival) = (yyvsp[0].ival); 
       }
-#line 1889 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1915 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 35:
-#line 313 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 37:
+#line 320 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.drop_table_statement) = new FLOPPYDropTableStatement();
          (yyval.drop_table_statement)->table = (yyvsp[0].sval);
       }
-#line 1898 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1924 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 36:
-#line 326 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 38:
+#line 333 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
       (yyval.create_index_statement) = new FLOPPYCreateIndexStatement();
       (yyval.create_index_statement)->name = (yyvsp[-5].sval);
       (yyval.create_index_statement)->tableReference = (yyvsp[-3].sval);
       (yyval.create_index_statement)->attributes = (yyvsp[-1].str_vec);
    }
-#line 1909 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1935 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 37:
-#line 338 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 39:
+#line 345 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.drop_index_statement) = new FLOPPYDropIndexStatement();
          (yyval.drop_index_statement)->indexName = (yyvsp[-2].sval);
          (yyval.drop_index_statement)->tableName = (yyvsp[0].sval);
       }
-#line 1919 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1945 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 38:
-#line 352 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 40:
+#line 359 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.insert_statement) = new FLOPPYInsertStatement();
          (yyval.insert_statement)->name = (yyvsp[-4].sval);
          (yyval.insert_statement)->values = (yyvsp[-1].value_vec);
       }
-#line 1929 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1955 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 39:
-#line 360 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 41:
+#line 367 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.value_vec) = new std::vector<FLOPPYValue *>();
          (yyval.value_vec)->push_back((yyvsp[0].value));
       }
-#line 1938 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1964 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 40:
-#line 364 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 42:
+#line 371 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.value_vec) = (yyvsp[-2].value_vec);
          (yyval.value_vec)->push_back((yyvsp[0].value));
       }
-#line 1947 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1973 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 41:
-#line 371 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 43:
+#line 378 "FLOPPY_parser.y" /* yacc.c:1661  */
     { (yyval.value) = (yyvsp[0].value); }
-#line 1953 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1979 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 42:
-#line 372 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 44:
+#line 379 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.value) = new FLOPPYValue(BooleanValue);
          (yyval.value)->bVal = true;
       }
-#line 1962 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1988 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 43:
-#line 376 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 45:
+#line 383 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.value) = new FLOPPYValue(BooleanValue);
          (yyval.value)->bVal = false;
       }
-#line 1971 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 1997 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 44:
-#line 383 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 46:
+#line 390 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.value) = new FLOPPYValue(IntValue);
          (yyval.value)->iVal = (yyvsp[0].ival);
       }
-#line 1980 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2006 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 45:
-#line 387 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 47:
+#line 394 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.value) = new FLOPPYValue(IntValue);
          (yyval.value)->iVal = -(yyvsp[0].ival);
       }
-#line 1989 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2015 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 46:
-#line 391 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 48:
+#line 398 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.value) = new FLOPPYValue(FloatValue);
          (yyval.value)->fVal = (yyvsp[0].fval);
       }
-#line 1998 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2024 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 47:
-#line 395 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 49:
+#line 402 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.value) = new FLOPPYValue(StringValue);
          (yyval.value)->sVal = (yyvsp[0].sval);
       }
-#line 2007 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2033 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 48:
-#line 399 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 50:
+#line 406 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.value) = new FLOPPYValue(NullValue);
          (yyval.value)->sVal = NULL;
       }
-#line 2016 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2042 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 49:
-#line 412 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 51:
+#line 419 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.delete_statement) = new FLOPPYDeleteStatement();
          (yyval.delete_statement)->name = (yyvsp[-2].sval);
          (yyval.delete_statement)->where = (yyvsp[0].node);
       }
-#line 2026 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2052 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 50:
-#line 420 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 52:
+#line 427 "FLOPPY_parser.y" /* yacc.c:1661  */
     { (yyval.node) = (yyvsp[0].node); }
-#line 2032 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2058 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 51:
-#line 421 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 53:
+#line 428 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ConditionNode);
          (yyval.node)->node.left = (yyvsp[-2].node);
          (yyval.node)->node.op = FLOPPYNodeOperator::AndOperator;
          (yyval.node)->node.right= (yyvsp[0].node);
       }
-#line 2043 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2069 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 52:
-#line 427 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 54:
+#line 434 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ConditionNode);
          (yyval.node)->node.left = (yyvsp[0].node);
          (yyval.node)->node.op = FLOPPYNodeOperator::NotOperator;
       }
-#line 2053 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2079 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 53:
-#line 432 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 55:
+#line 439 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ConditionNode);
          (yyval.node)->node.left = (yyvsp[-1].node);
          (yyval.node)->node.op = FLOPPYNodeOperator::ParenthesisOperator;
    }
-#line 2063 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2089 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 54:
-#line 440 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 56:
+#line 447 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ConditionNode);
          (yyval.node)->node.left = (yyvsp[-2].node);
          (yyval.node)->node.op = FLOPPYNodeOperator::LessThanOperator;
          (yyval.node)->node.right= (yyvsp[0].node);
       }
-#line 2074 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2100 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 55:
-#line 446 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 57:
+#line 453 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ConditionNode);
          (yyval.node)->node.left = (yyvsp[-2].node);
          (yyval.node)->node.op = FLOPPYNodeOperator::GreaterThanOperator;
          (yyval.node)->node.right= (yyvsp[0].node);
       }
-#line 2085 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2111 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 56:
-#line 452 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 58:
+#line 459 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ConditionNode);
          (yyval.node)->node.left = (yyvsp[-2].node);
          (yyval.node)->node.op = FLOPPYNodeOperator::EqualOperator;
          (yyval.node)->node.right= (yyvsp[0].node);
       }
-#line 2096 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2122 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 57:
-#line 458 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 59:
+#line 465 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ConditionNode);
          (yyval.node)->node.left = (yyvsp[-2].node);
          (yyval.node)->node.op = FLOPPYNodeOperator::LessThanEqualOperator;
          (yyval.node)->node.right= (yyvsp[0].node);
       }
-#line 2107 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2133 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 58:
-#line 464 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 60:
+#line 471 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ConditionNode);
          (yyval.node)->node.left = (yyvsp[-2].node);
          (yyval.node)->node.op = FLOPPYNodeOperator::GreaterThanEqualOperator;
          (yyval.node)->node.right= (yyvsp[0].node);
       }
-#line 2118 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2144 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 59:
-#line 470 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 61:
+#line 477 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ConditionNode);
          (yyval.node)->node.left = (yyvsp[-2].node);
          (yyval.node)->node.op = FLOPPYNodeOperator::NotEqualOperator;
          (yyval.node)->node.right= (yyvsp[0].node);
       }
-#line 2129 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2155 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 60:
-#line 476 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 62:
+#line 483 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.node) = new FLOPPYNode(ValueNode); 
          (yyval.node)->value = new FLOPPYValue(BooleanValue);
          (yyval.node)->value->bVal = true;
       }
-#line 2139 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2165 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 61:
-#line 481 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 63:
+#line 488 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ValueNode); 
          (yyval.node)->value = new FLOPPYValue(BooleanValue);
          (yyval.node)->value->bVal = false;
       }
-#line 2149 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2175 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 62:
-#line 489 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 64:
+#line 496 "FLOPPY_parser.y" /* yacc.c:1661  */
     { (yyval.node) = (yyvsp[0].node); }
-#line 2155 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2181 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 63:
-#line 490 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 65:
+#line 497 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ExpressionNode);
          (yyval.node)->node.left = (yyvsp[-2].node);
          (yyval.node)->node.op = FLOPPYNodeOperator::PlusOperator;
          (yyval.node)->node.right= (yyvsp[0].node);
       }
-#line 2166 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2192 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 64:
-#line 496 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 66:
+#line 503 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ExpressionNode);
          (yyval.node)->node.left = (yyvsp[-2].node);
          (yyval.node)->node.op = FLOPPYNodeOperator::MinusOperator;
          (yyval.node)->node.right= (yyvsp[0].node);
       }
-#line 2177 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2203 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 65:
-#line 502 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 67:
+#line 509 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ExpressionNode);
          (yyval.node)->node.left = (yyvsp[-2].node);
          (yyval.node)->node.op = FLOPPYNodeOperator::TimesOperator;
          (yyval.node)->node.right= (yyvsp[0].node);
       }
-#line 2188 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2214 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 66:
-#line 508 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 68:
+#line 515 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ExpressionNode);
          (yyval.node)->node.left = (yyvsp[-2].node);
          (yyval.node)->node.op = FLOPPYNodeOperator::DivideOperator;
          (yyval.node)->node.right= (yyvsp[0].node);
       }
-#line 2199 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2225 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 67:
-#line 514 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 69:
+#line 521 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ExpressionNode);
          (yyval.node)->node.left = (yyvsp[-2].node);
          (yyval.node)->node.op = FLOPPYNodeOperator::ModOperator;
          (yyval.node)->node.right= (yyvsp[0].node);
       }
-#line 2210 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2236 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 68:
-#line 520 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 70:
+#line 527 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ExpressionNode);
          (yyval.node)->node.op = FLOPPYNodeOperator::ParenthesisOperator;
          (yyval.node)->node.left = (yyvsp[-1].node);
       }
-#line 2220 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2246 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 69:
-#line 528 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 71:
+#line 535 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ValueNode);
          (yyval.node)->value = new FLOPPYValue(TableAttributeValue);
          (yyval.node)->value->tableAttribute = (yyvsp[0].table_attribute);
       }
-#line 2230 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2256 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 70:
-#line 533 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 72:
+#line 540 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(ValueNode);
          (yyval.node)->value = (yyvsp[0].value);
       }
-#line 2239 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2265 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 71:
-#line 537 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 73:
+#line 544 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(AggregateNode);
          (yyval.node)->aggregate.op = FLOPPYAggregateOperator::MinAggregate;
          (yyval.node)->aggregate.value = new FLOPPYValue(AttributeValue);
          (yyval.node)->aggregate.value->sVal = (yyvsp[-1].sval);
       }
-#line 2250 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2276 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 72:
-#line 543 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 74:
+#line 550 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(AggregateNode);
          (yyval.node)->aggregate.op = FLOPPYAggregateOperator::MaxAggregate;
          (yyval.node)->aggregate.value = new FLOPPYValue(AttributeValue);
          (yyval.node)->aggregate.value->sVal = (yyvsp[-1].sval);
       }
-#line 2261 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2287 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 73:
-#line 549 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 75:
+#line 556 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(AggregateNode);
          (yyval.node)->aggregate.op = FLOPPYAggregateOperator::SumAggregate;
          (yyval.node)->aggregate.value = new FLOPPYValue(AttributeValue);
          (yyval.node)->aggregate.value->sVal = (yyvsp[-1].sval);
       }
-#line 2272 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2298 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 74:
-#line 555 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 76:
+#line 562 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(AggregateNode);
          (yyval.node)->aggregate.op = FLOPPYAggregateOperator::AverageAggregate;
          (yyval.node)->aggregate.value = new FLOPPYValue(AttributeValue);
          (yyval.node)->aggregate.value->sVal = (yyvsp[-1].sval);
       }
-#line 2283 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2309 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 75:
-#line 561 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 77:
+#line 568 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(AggregateNode);
          (yyval.node)->aggregate.op = FLOPPYAggregateOperator::CountAggregate;
          (yyval.node)->aggregate.value = new FLOPPYValue(AttributeValue);
          (yyval.node)->aggregate.value->sVal = (yyvsp[-1].sval);
       }
-#line 2294 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2320 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 76:
-#line 567 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 78:
+#line 574 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = new FLOPPYNode(AggregateNode);
          (yyval.node)->aggregate.op = FLOPPYAggregateOperator::CountStarAggregate;
          (yyval.node)->aggregate.value = NULL;
       }
-#line 2304 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2330 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 77:
-#line 583 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 79:
+#line 590 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.update_statement) = new FLOPPYUpdateStatement();
          (yyval.update_statement)->tableName = (yyvsp[-6].sval);
@@ -2312,11 +2338,28 @@ yyreduce:
          (yyval.update_statement)->attributeExpression= (yyvsp[-2].node);
          (yyval.update_statement)->whereExpression = (yyvsp[0].node);
       }
-#line 2316 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2342 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 78:
-#line 608 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 80:
+#line 604 "FLOPPY_parser.y" /* yacc.c:1661  */
+    {
+         (yyval.show_buffer_stats_statement) = new FLOPPYShowBufferStatsStatement();
+      }
+#line 2350 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+    break;
+
+  case 81:
+#line 614 "FLOPPY_parser.y" /* yacc.c:1661  */
+    {
+         (yyval.set_buffer_size_statement) = new FLOPPYSetBufferSizeStatement();
+         (yyval.set_buffer_size_statement)->nBlocks = (yyvsp[0].ival);
+      }
+#line 2359 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+    break;
+
+  case 82:
+#line 636 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.select_statement) = new FLOPPYSelectStatement();
          (yyval.select_statement)->distinct = (yyvsp[-7].bval);
@@ -2327,298 +2370,298 @@ yyreduce:
          (yyval.select_statement)->orderBys = (yyvsp[-1].table_attr_vec);
          (yyval.select_statement)->limit= (yyvsp[0].ival);
       }
-#line 2331 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2374 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 79:
-#line 621 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 83:
+#line 649 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.select_item_vec) = new std::vector<FLOPPYSelectItem *>();
          (yyval.select_item_vec)->push_back(new FLOPPYSelectItem(FLOPPYSelectItemType::StarType));
       }
-#line 2340 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2383 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 80:
-#line 625 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 84:
+#line 653 "FLOPPY_parser.y" /* yacc.c:1661  */
     { (yyval.select_item_vec) = (yyvsp[0].select_item_vec); }
-#line 2346 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2389 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 81:
-#line 628 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 85:
+#line 656 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.select_item_vec) = new std::vector<FLOPPYSelectItem *>(); 
          (yyval.select_item_vec)->push_back((yyvsp[0].select_item));
       }
-#line 2355 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2398 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 82:
-#line 632 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 86:
+#line 660 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.select_item_vec) = (yyvsp[-2].select_item_vec);
          (yyval.select_item_vec)->push_back((yyvsp[0].select_item));
       }
-#line 2364 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2407 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 83:
-#line 639 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 87:
+#line 667 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.select_item) = new FLOPPYSelectItem(FLOPPYSelectItemType::TableAttributeType);
          (yyval.select_item)->tableAttribute = (yyvsp[0].table_attribute);
       }
-#line 2373 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2416 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 84:
-#line 643 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 88:
+#line 671 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.select_item) = new FLOPPYSelectItem(FLOPPYSelectItemType::AggregateType);
          (yyval.select_item)->aggregate.op = FLOPPYAggregateOperator::CountAggregate;
          (yyval.select_item)->aggregate.value = new FLOPPYValue(ValueType::AttributeValue);
          (yyval.select_item)->aggregate.value->sVal = (yyvsp[-1].sval);
       }
-#line 2384 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2427 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 85:
-#line 649 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 89:
+#line 677 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.select_item) = new FLOPPYSelectItem(FLOPPYSelectItemType::AggregateType);
          (yyval.select_item)->aggregate.op = FLOPPYAggregateOperator::AverageAggregate;
          (yyval.select_item)->aggregate.value = new FLOPPYValue(ValueType::AttributeValue);
          (yyval.select_item)->aggregate.value->sVal = (yyvsp[-1].sval);
       }
-#line 2395 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2438 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 86:
-#line 655 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 90:
+#line 683 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.select_item) = new FLOPPYSelectItem(FLOPPYSelectItemType::AggregateType);
          (yyval.select_item)->aggregate.op = FLOPPYAggregateOperator::MaxAggregate;
          (yyval.select_item)->aggregate.value = new FLOPPYValue(ValueType::AttributeValue);
          (yyval.select_item)->aggregate.value->sVal = (yyvsp[-1].sval);
       }
-#line 2406 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2449 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 87:
-#line 661 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 91:
+#line 689 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.select_item) = new FLOPPYSelectItem(FLOPPYSelectItemType::AggregateType);
          (yyval.select_item)->aggregate.op = FLOPPYAggregateOperator::MinAggregate;
          (yyval.select_item)->aggregate.value = new FLOPPYValue(ValueType::AttributeValue);
          (yyval.select_item)->aggregate.value->sVal = (yyvsp[-1].sval);
       }
-#line 2417 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2460 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 88:
-#line 667 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 92:
+#line 695 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.select_item) = new FLOPPYSelectItem(FLOPPYSelectItemType::AggregateType);
          (yyval.select_item)->aggregate.op = FLOPPYAggregateOperator::SumAggregate;
          (yyval.select_item)->aggregate.value = new FLOPPYValue(ValueType::AttributeValue);
          (yyval.select_item)->aggregate.value->sVal = (yyvsp[-1].sval);
       }
-#line 2428 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2471 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 89:
-#line 673 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 93:
+#line 701 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.select_item) = new FLOPPYSelectItem(FLOPPYSelectItemType::AggregateType);
          (yyval.select_item)->aggregate.op = FLOPPYAggregateOperator::CountStarAggregate;
          (yyval.select_item)->aggregate.value = NULL;
       }
-#line 2438 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2481 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 90:
-#line 681 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 94:
+#line 709 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.table_spec_vec) = new std::vector<FLOPPYTableSpec *>();
          (yyval.table_spec_vec)->push_back((yyvsp[0].table_spec));
       }
-#line 2447 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2490 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 91:
-#line 685 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 95:
+#line 713 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.table_spec_vec) = (yyvsp[-2].table_spec_vec);
          (yyval.table_spec_vec)->push_back((yyvsp[0].table_spec));
       }
-#line 2456 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2499 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 92:
-#line 692 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 96:
+#line 720 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.table_spec) = new FLOPPYTableSpec();
          (yyval.table_spec)->tableName = (yyvsp[0].sval);
          (yyval.table_spec)->alias = NULL;
       }
-#line 2466 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2509 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 93:
-#line 697 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 97:
+#line 725 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.table_spec) = new FLOPPYTableSpec();
          (yyval.table_spec)->tableName = (yyvsp[-1].sval);
          (yyval.table_spec)->alias = (yyvsp[0].sval);
       }
-#line 2476 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2519 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 94:
-#line 702 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 98:
+#line 730 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.table_spec) = new FLOPPYTableSpec();
          (yyval.table_spec)->tableName = (yyvsp[-2].sval);
          (yyval.table_spec)->alias = (yyvsp[0].sval);
       }
-#line 2486 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2529 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 95:
-#line 710 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 99:
+#line 738 "FLOPPY_parser.y" /* yacc.c:1661  */
     { (yyval.bval) = true; }
-#line 2492 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2535 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 96:
-#line 711 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 100:
+#line 739 "FLOPPY_parser.y" /* yacc.c:1661  */
     { (yyval.bval) = false; }
-#line 2498 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2541 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 97:
-#line 715 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 101:
+#line 743 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = (yyvsp[0].node);
       }
-#line 2506 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2549 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 98:
-#line 718 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 102:
+#line 746 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = NULL;
       }
-#line 2514 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2557 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 99:
-#line 725 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 103:
+#line 753 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.group_by) = new FLOPPYGroupBy();
          (yyval.group_by)->groupByAttributes = (yyvsp[-1].table_attr_vec);
          (yyval.group_by)->havingCondition = (yyvsp[0].node);
       }
-#line 2524 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2567 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 100:
-#line 730 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 104:
+#line 758 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.group_by) = NULL;
       }
-#line 2532 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2575 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 101:
-#line 736 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 105:
+#line 764 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.node) = (yyvsp[0].node);
       }
-#line 2540 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2583 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 102:
-#line 739 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 106:
+#line 767 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.node) = NULL;
       }
-#line 2548 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2591 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 103:
-#line 745 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 107:
+#line 773 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.table_attr_vec) = (yyvsp[0].table_attr_vec);
       }
-#line 2556 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2599 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 104:
-#line 748 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 108:
+#line 776 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.table_attr_vec) = NULL;
       }
-#line 2564 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2607 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 105:
-#line 754 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 109:
+#line 782 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.ival) = (yyvsp[0].ival);
       }
-#line 2572 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2615 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 106:
-#line 757 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 110:
+#line 785 "FLOPPY_parser.y" /* yacc.c:1661  */
     { 
          (yyval.ival) = -1;
       }
-#line 2580 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2623 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 107:
-#line 763 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 111:
+#line 791 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.table_attr_vec) = new std::vector<FLOPPYTableAttribute *>();
          (yyval.table_attr_vec)->push_back((yyvsp[0].table_attribute));
       }
-#line 2589 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2632 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 108:
-#line 767 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 112:
+#line 795 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.table_attr_vec) = (yyvsp[-2].table_attr_vec);
          (yyval.table_attr_vec)->push_back((yyvsp[0].table_attribute));
       }
-#line 2598 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2641 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 109:
-#line 774 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 113:
+#line 802 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.table_attribute) = new FLOPPYTableAttribute();
          (yyval.table_attribute)->tableName = NULL;
          (yyval.table_attribute)->attribute = (yyvsp[0].sval);
       }
-#line 2608 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2651 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
-  case 110:
-#line 779 "FLOPPY_parser.y" /* yacc.c:1661  */
+  case 114:
+#line 807 "FLOPPY_parser.y" /* yacc.c:1661  */
     {
          (yyval.table_attribute) = new FLOPPYTableAttribute();
          (yyval.table_attribute)->tableName = (yyvsp[-2].sval);
          (yyval.table_attribute)->attribute = (yyvsp[0].sval);
       }
-#line 2618 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2661 "FLOPPY_parser.cpp" /* yacc.c:1661  */
     break;
 
 
-#line 2622 "FLOPPY_parser.cpp" /* yacc.c:1661  */
+#line 2665 "FLOPPY_parser.cpp" /* yacc.c:1661  */
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -106,7 +106,11 @@ typedef void* yyscan_t;
     FLOPPY_FLOAT = 305,
     FLOPPY_BOOLEAN = 306,
     FLOPPY_DATETIME = 307,
-    FLOPPY_VARCHAR = 308
+    FLOPPY_VARCHAR = 308,
+    FLOPPY_SHOW = 309,
+    FLOPPY_BUFFER = 310,
+    FLOPPY_STATS = 311,
+    FLOPPY_SIZE = 312
   };
 #endif
 
@@ -131,6 +135,8 @@ union YYSTYPE
    FLOPPYDeleteStatement *delete_statement;
    FLOPPYUpdateStatement *update_statement;
    FLOPPYSelectStatement *select_statement;
+   FLOPPYShowBufferStatsStatement *show_buffer_stats_statement;
+   FLOPPYSetBufferSizeStatement *set_buffer_size_statement;
    FLOPPYForeignKey *foreign_key;
    FLOPPYSelectItem *select_item;
    FLOPPYTableSpec *table_spec;
@@ -152,7 +158,7 @@ union YYSTYPE
    FLOPPYValue *value;
    FLOPPYNode *node;
 
-#line 156 "FLOPPY_parser.h" /* yacc.c:1915  */
+#line 162 "FLOPPY_parser.h" /* yacc.c:1915  */
 };
 
 typedef union YYSTYPE YYSTYPE;
@@ -56,6 +56,8 @@ typedef void* yyscan_t;
    FLOPPYDeleteStatement *delete_statement;
    FLOPPYUpdateStatement *update_statement;
    FLOPPYSelectStatement *select_statement;
+   FLOPPYShowBufferStatsStatement *show_buffer_stats_statement;
+   FLOPPYSetBufferSizeStatement *set_buffer_size_statement;
    FLOPPYForeignKey *foreign_key;
    FLOPPYSelectItem *select_item;
    FLOPPYTableSpec *table_spec;
@@ -88,6 +90,7 @@ typedef void* yyscan_t;
 %token COUNT AVERAGE MAX MIN SUM NULL AS
 %token NOT MOD LE GE NE TRUE FALSE AND
 %token INT FLOAT BOOLEAN DATETIME VARCHAR 
+%token SHOW BUFFER STATS SIZE
 
 %type <flags>                    opt_volatile opt_index_only opt_split
 %type <ival>                     int_literal opt_column_size column_type opt_limit
@@ -102,6 +105,8 @@ typedef void* yyscan_t;
 %type <delete_statement>         delete_statement
 %type <update_statement>         update_statement
 %type <select_statement>         select_statement
+%type <show_buffer_stats_statement> show_buffer_stats_statement
+%type <set_buffer_size_statement> set_buffer_size_statement
 
 %type <create_column>            column_def
 %type <node>                     condition atomic_condition expression atomic_expression opt_where opt_having
@@ -154,6 +159,8 @@ statement:
    |  delete_statement { $$ = $1; }
    |  update_statement { $$ = $1; }
    |  select_statement { $$ = $1; }
+   |  show_buffer_stats_statement { $$ = $1; }
+   |  set_buffer_size_statement { $$ = $1; }
 	;
 
 /******************************
@@ -589,6 +596,27 @@ update_statement:
       }
    ;
 
+/******************************
+ * Show Buffer Stats Statement
+ * SHOW BUFFER STATS;
+ ******************************/
+show_buffer_stats_statement:
+      SHOW BUFFER STATS {
+         $$ = new FLOPPYShowBufferStatsStatement();
+      }
+   ;
+
+/******************************
+ * Set Buffer Size Statement
+ * SET BUFFER SIZE <Blocks>;
+ ******************************/
+set_buffer_size_statement:
+      SET BUFFER SIZE INTVAL {
+         $$ = new FLOPPYSetBufferSizeStatement();
+         $$->nBlocks = $4;
+      }
+   ;
+
 /******************************
  * Select Statement
  * SELECT [DISTINCT] <SelectItem>[, <SelectItem>]*
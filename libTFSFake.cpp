@@ -1,6 +1,11 @@
+#include <errno.h>
 #include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <map>
 #include <string>
 #include "libTinyFS.h"
@@ -10,12 +15,59 @@ using namespace std;
 
 static map<int, string> fdToName;
 static map<string, int> nameToFd;
+static int directIO = 0;
+static int mkfsPageSize = DEFAULT_BLOCKSIZE;
 
-int tfs_mkfs(char *filename, int nBytes) {
+int tfs_blockSize = DEFAULT_BLOCKSIZE;
+
+/* all the disk file holds, the files themselves live next to it */
+typedef struct {
+   char magic;
+   int pageSize;
+} SuperBlock;
+
+static int validPageSize(int size) {
+   return size == DEFAULT_BLOCKSIZE || size == 4096 || size == 8192
+    || size == 16384 || size == 32768;
+}
+
+int tfs_setPageSize(int size) {
+   if (!validPageSize(size))
+      return -1;
+   mkfsPageSize = size;
    return 0;
 }
 
+int tfs_mkfs(char *filename, int nBytes) {
+   SuperBlock sb;
+   memset(&sb, 0, sizeof(sb));
+   sb.magic = TFS_MAGICNUMBER;
+   sb.pageSize = mkfsPageSize;
+
+   int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+   if (fd < 0) {
+      perror("tfs_mkfs");
+      return -1;
+   }
+   int n = write(fd, &sb, sizeof(sb));
+   close(fd);
+   return n == sizeof(sb) ? 0 : -1;
+}
+
 int tfs_mount(char *filename) {
+   SuperBlock sb;
+   int fd = open(filename, O_RDONLY);
+   if (fd < 0) {
+      perror("tfs_mount");
+      return -1;
+   }
+   int n = read(fd, &sb, sizeof(sb));
+   close(fd);
+   if (n != sizeof(sb) || sb.magic != TFS_MAGICNUMBER || !validPageSize(sb.pageSize)) {
+      fprintf(stderr, "tfs_mount: %s is not a file system\n", filename);
+      return -1;
+   }
+   tfs_blockSize = sb.pageSize;
    return 0;
 }
 
@@ -23,8 +75,15 @@ int tfs_unmount(void) {
    return 0;
 }
 
+int tfs_setDirectIO(int on) {
+   directIO = on;
+   return 0;
+}
+
 fileDescriptor tfs_openFile(char *name) {
-   int fd = open(name, O_RDWR | O_CREAT, 0666);
+   int fd = open(name, O_RDWR | O_CREAT | (directIO ? O_DIRECT : 0), 0666);
+   if (fd < 0 && directIO && errno == EINVAL) /* e.g. tmpfs */
+      fd = open(name, O_RDWR | O_CREAT, 0666);
    //printf("tfs_openFile, opening %d, %s\n", fd, name);
    if (fd < 0)
       perror("tfs_openFile");
@@ -40,18 +99,89 @@ int tfs_closeFile(fileDescriptor FD) {
    return close(FD);
 }
 
+static int isAligned(const void *data) {
+   return ((uintptr_t)data & (TFS_DIRECT_ALIGN - 1)) == 0;
+}
+
+/* called after a failed transfer on FD. If direct I/O was the reason (say a
+ * disk with sectors bigger than a page), turns it off for FD and returns 1
+ * so the caller tries again. */
+static int dropDirectIO(fileDescriptor FD) {
+   int flags;
+   if (errno != EINVAL || (flags = fcntl(FD, F_GETFL)) < 0 || !(flags & O_DIRECT))
+      return 0;
+   return fcntl(FD, F_SETFL, flags & ~O_DIRECT) == 0;
+}
+
+/* an aligned page for each thread to copy unaligned pages through */
+static unsigned char *bouncePage() {
+   static thread_local unsigned char page[MAX_BLOCKSIZE]
+    __attribute__((aligned(TFS_DIRECT_ALIGN)));
+   return page;
+}
+
 int tfs_writePage(fileDescriptor FD, unsigned int page, unsigned char *data) {
-   lseek(FD, page * BLOCKSIZE, SEEK_SET);
-   write(FD, data, BLOCKSIZE);
-   return 0;
+   ssize_t n;
+   if (directIO && !isAligned(data)) {
+      memcpy(bouncePage(), data, BLOCKSIZE);
+      data = bouncePage();
+   }
+   /* positional, so the background writer can't move a reader's offset */
+   while ((n = pwrite(FD, data, BLOCKSIZE, (off_t)page * BLOCKSIZE)) < 0 && dropDirectIO(FD))
+      ;
+   return n == BLOCKSIZE ? 0 : -1;
 }
 
 int tfs_readPage(fileDescriptor FD, unsigned int page, unsigned char *data) {
-   lseek(FD, page * BLOCKSIZE, SEEK_SET);
-   read(FD, data, BLOCKSIZE);
+   unsigned char *to = directIO && !isAligned(data) ? bouncePage() : data;
+   ssize_t n;
+   while ((n = pread(FD, to, BLOCKSIZE, (off_t)page * BLOCKSIZE)) < 0 && dropDirectIO(FD))
+      ;
+   if (n != BLOCKSIZE)
+      return -1;
+   if (to != data)
+      memcpy(data, to, BLOCKSIZE);
    return 0;
 }
 
+int tfs_readPages(fileDescriptor FD, unsigned int page, unsigned char **data, int count) {
+   struct iovec iov[count];
+   ssize_t n;
+   for (int i = 0; i < count; i++) {
+      if (directIO && !isAligned(data[i])) { /* page at a time then */
+         for (i = 0; i < count; i++) {
+            if (tfs_readPage(FD, page + i, data[i]) < 0)
+               return -1;
+         }
+         return 0;
+      }
+      iov[i].iov_base = data[i];
+      iov[i].iov_len = BLOCKSIZE;
+   }
+   while ((n = preadv(FD, iov, count, (off_t)page * BLOCKSIZE)) < 0 && dropDirectIO(FD))
+      ;
+   return n == (ssize_t)count * BLOCKSIZE ? 0 : -1;
+}
+
+int tfs_writePages(fileDescriptor FD, unsigned int page, unsigned char **data, int count) {
+   struct iovec iov[count];
+   ssize_t n;
+   for (int i = 0; i < count; i++) {
+      if (directIO && !isAligned(data[i])) {
+         for (i = 0; i < count; i++) {
+            if (tfs_writePage(FD, page + i, data[i]) < 0)
+               return -1;
+         }
+         return 0;
+      }
+      iov[i].iov_base = data[i];
+      iov[i].iov_len = BLOCKSIZE;
+   }
+   while ((n = pwritev(FD, iov, count, (off_t)page * BLOCKSIZE)) < 0 && dropDirectIO(FD))
+      ;
+   return n == (ssize_t)count * BLOCKSIZE ? 0 : -1;
+}
+
 int tfs_numPages(fileDescriptor FD) {
    struct stat st;
    fstat(FD, &st);
@@ -72,3 +202,8 @@ int getFd(string name) {
 
    return nameToFd[name];
 }
+
+string getFileName(fileDescriptor FD) {
+   map<int, string>::iterator it = fdToName.find(FD);
+   return it == fdToName.end() ? "" : it->second;
+}
@@ -10,6 +10,12 @@ typedef int fileDescriptor;
  * Must return a specified success/error code. */
 int tfs_mkfs(char *filename, int nBytes);
 
+/* tfs_setPageSize(size) sets the page size of the file systems tfs_mkfs
+ * makes from then on: DEFAULT_BLOCKSIZE or 4, 8, 16 or 32 KB. A file
+ * system keeps the size it was made with, and tfs_mount makes it BLOCKSIZE.
+ * Returns -1 for any other size. */
+int tfs_setPageSize(int size);
+
 /* tfs_mount(char *filename) mounts a TinyFS file system located within
  * 'filename'. tfs_unmount(void) unmounts the currently mounted file system.
  * As part of the mount operation, tfs_mount should verify the file system is
@@ -36,8 +42,22 @@ int tfs_writeFile(fileDescriptor FD, char *buffer, int size);
 
 /* TFS468 read/write page */
 int tfs_writePage_size(fileDescriptor FD, unsigned int page, unsigned char *data, int size);
+/* the page calls return 0, or -1 if the transfer failed or moved less than
+ * every byte of every page */
 int tfs_writePage(fileDescriptor FD, unsigned int page, unsigned char *data);
 int tfs_readPage(fileDescriptor FD, unsigned int page, unsigned char *data);
+/* reads count consecutive pages starting at page, one page into each data[i] */
+int tfs_readPages(fileDescriptor FD, unsigned int page, unsigned char **data, int count);
+/* writes data[i] to page + i for count consecutive pages in one call */
+int tfs_writePages(fileDescriptor FD, unsigned int page, unsigned char **data, int count);
+
+/* tfs_setDirectIO(on) makes the files opened from then on bypass the
+ * kernel page cache when on is nonzero. Direct transfers need buffers
+ * aligned to TFS_DIRECT_ALIGN; pages in unaligned buffers are copied
+ * through an aligned one. A file whose file system or disk refuses direct
+ * I/O falls back to buffered I/O. */
+#define TFS_DIRECT_ALIGN 512
+int tfs_setDirectIO(int on);
 
 /* returns number of pages on a TFS486 file including the first page (inode) */
 int tfs_numPages(fileDescriptor FD);
@@ -66,4 +86,7 @@ int tfs_readDir(void);
 /* Displays the creation, last modification, and last access times of a file */
 int tfs_readFileInfo(fileDescriptor FD);
 
-int getFd(std::string name);
\ No newline at end of file
+int getFd(std::string name);
+
+/* returns the name of the open file FD, or "" if there is none */
+std::string getFileName(fileDescriptor FD);
\ No newline at end of file
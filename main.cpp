@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <limits.h>
 #include <algorithm>
 #include <map>
 #include <set>
@@ -23,6 +24,7 @@
 
 #define PORT_NUM 5000
 
+/* defaults, main() takes FLOPPY_BUF_BLOCKS and FLOPPY_CACHE_BLOCKS over these */
 #define BUF_BLOCKS 500
 #define CACHE_BLOCKS 500
 
@@ -471,20 +473,20 @@ void makePhysicalPlan(QueryPlan *plan) {
 
 // this returns the fd of the file in which the result is stored
 int executeQueryPlan(QueryPlan *plan) {
-   int in, in2 = -1, out;
+   int in, in2 = -1, out, ret = 0;
 
    switch (plan->type) {
       case TABLE: //printf("executeQueryPlan: TABLE\n");
          return getFd(plan->strVal);
       case ALIAS: //printf("executeQueryPlan: ALIAS\n");
          in = executeQueryPlan(plan->left);
-         renameTable(in, plan->strVal, &out);
+         ret = renameTable(in, plan->strVal, &out);
          break;
       case SELECT: //printf("executeQueryPlan: SELECT\n");
          in = executeQueryPlan(plan->left);
          // TODO actually deal with index stuff
          //if (plan->impl == 0) {
-            selectScan(in, plan->cond, &out);
+            ret = selectScan(in, plan->cond, &out);
          //}
          //else {
          //   selectIndex(in, plan->cond, index, &out);
@@ -492,43 +494,46 @@ int executeQueryPlan(QueryPlan *plan) {
          break;
       case PROJECT: //printf("executeQueryPlan: PROJECT\n");
          in = executeQueryPlan(plan->left);
-         project(in, plan->attList, &out);
+         ret = project(in, plan->attList, &out);
          break;
       case DUPLICATE: //printf("executeQueryPlan: DUPLICATE\n");
          in = executeQueryPlan(plan->left);
-         duplicateElimination(in, plan->attList, &out);
+         ret = duplicateElimination(in, plan->attList, &out);
          break;
       case PRODUCT: //printf("executeQueryPlan: PRODUCT\n");
          in = executeQueryPlan(plan->left);
          in2 = executeQueryPlan(plan->right);
-         product(in, in2, &out);
+         ret = product(in, in2, &out);
          break;
       case JOIN: //printf("executeQueryPlan: JOIN\n");
          in = executeQueryPlan(plan->left);
          in2 = executeQueryPlan(plan->right);
          if (plan->impl == 0)
-            joinOnePass(in, in2, plan->cond, &out);
+            ret = joinOnePass(in, in2, plan->cond, &out);
          else if (plan->impl == 1)
-            joinMultiPass(in, in2, plan->cond, &out);
+            ret = joinMultiPass(in, in2, plan->cond, &out);
          else
-            joinNestedLoops(in, in2, plan->cond, &out);
+            ret = joinNestedLoops(in, in2, plan->cond, &out);
          break;
       case GROUP: //printf("executeQueryPlan: GROUP\n");
          in = executeQueryPlan(plan->left);
          if (plan->impl == 0)
-            groupOnePass(in, plan->grouping.groupBy, plan->grouping.aggregates, &out);
+            ret = groupOnePass(in, plan->grouping.groupBy, plan->grouping.aggregates, &out);
          else
-            groupMultiPass(in, plan->grouping.groupBy, plan->grouping.aggregates, &out);
+            ret = groupMultiPass(in, plan->grouping.groupBy, plan->grouping.aggregates, &out);
          break;
       case SORT: //printf("executeQueryPlan: SORT\n");
          in = executeQueryPlan(plan->left);
-         sortTable(in, plan->attList, &out);
+         ret = sortTable(in, plan->attList, &out);
          break;
       case LIMIT: //printf("executeQueryPlan: LIMIT\n");
          in = executeQueryPlan(plan->left);
-         limitTable(in, plan->intVal, &out);
+         ret = limitTable(in, plan->intVal, &out);
    }
 
+   if (ret < 0)
+      fprintf(stderr, "could not write all of a query step's result\n");
+
    // delete temp tables
    if (plan->left->type != TABLE)
       deleteFile(buffer, in);
@@ -596,7 +601,8 @@ void createTableStatement(FLOPPYCreateTableStatement *stm) {
    if (access(stm->tableName.c_str(), F_OK) == 0) {
       struct stat st;
       stat(stm->tableName.c_str(), &st);
-      if (st.st_size > 0) {
+      // a volatile table's file stays empty, its pages are in memory
+      if (st.st_size > 0 || isMemoryOnly(buffer, getFd(stm->tableName))) {
          printf("Table %s already exists.\n", stm->tableName.c_str());
          return;
       }
@@ -622,8 +628,14 @@ void createTableStatement(FLOPPYCreateTableStatement *stm) {
       }
    }
 
-   createHeapFile(buffer, (char *)stm->tableName.c_str(), recordDesc, stm->flags->volatileFlag,
-    stm->pk, stm->fk);
+   int fd = createHeapFile(buffer, (char *)stm->tableName.c_str(), recordDesc,
+    stm->flags->volatileFlag, stm->pk, stm->fk);
+   if (fd < 0) {
+      printf("Could not create table %s.\n", stm->tableName.c_str());
+      return;
+   }
+   if (stm->flags->volatileFlag)
+      volatileFds.insert(fd);
    printf("Table created.\n");
 
    // TODO create indexes for primary and foreign keys
@@ -777,11 +789,6 @@ void insertStatement(FLOPPYInsertStatement *stm) {
 
    insertRecord(buffer, stm->name, record, &temp);
    printf("Tuple inserted.\n");
-
-   int isVolatile;
-   heapHeaderIsVolatile(buffer, fd, &isVolatile);
-   if (isVolatile)
-      volatileFds.insert(fd);
 }
 
 void deleteStatement(FLOPPYDeleteStatement *stm) {
@@ -819,6 +826,87 @@ void updateStatement(FLOPPYUpdateStatement *stm) {
    printf("%d tuples updated.\n", i);
 }
 
+/* counters go in INT columns, so they stop at INT_MAX rather than wrap */
+static int clampStat(long long n) {
+   return n > INT_MAX ? INT_MAX : (int)n;
+}
+
+/* adds one row of SHOW BUFFER STATS output to out */
+static void insertBufferStats(HeapWriter &out, RecordDesc desc, string name, BufferStats *stats) {
+   Record record;
+   long long lookups = stats->hits + stats->misses;
+
+   record.fields["file"] = RecordField(name.substr(0, NAME_LEN - 1));
+   record.fields["resident"] = RecordField(stats->resident);
+   record.fields["dirty"] = RecordField(stats->dirty);
+   record.fields["hits"] = RecordField(clampStat(stats->hits));
+   record.fields["misses"] = RecordField(clampStat(stats->misses));
+   record.fields["hit_ratio"] = RecordField(FLOAT, lookups ? (double)stats->hits / lookups : 0);
+   record.fields["evictions"] = RecordField(clampStat(stats->evictions));
+   record.fields["flushes"] = RecordField(clampStat(stats->flushes));
+   record.fields["bg_writes"] = RecordField(clampStat(stats->bgWrites));
+   record.fields["read_aheads"] = RecordField(clampStat(stats->readAheads));
+   record.fields["pin_waits"] = RecordField(clampStat(stats->pinWaits));
+   record.fields["all_pinned"] = RecordField(clampStat(stats->allPinned));
+   out.append(record.getBytes(desc));
+}
+
+/*
+ * Puts the buffer pool counters into a temp table, one row for the whole
+ * pool, one per file that has used it and one, "(dropped)", for the files
+ * deleted since. The counters are taken before the table is made, so its own
+ * pages do not show up.
+ */
+int showBufferStatsStatement(FLOPPYShowBufferStatsStatement *stm) {
+   static const char *columns[] = {"file", "resident", "dirty", "hits", "misses",
+    "hit_ratio", "evictions", "flushes", "bg_writes", "read_aheads", "pin_waits",
+    "all_pinned"};
+   BufferStats total;
+   map<int, BufferStats> files;
+   RecordDesc desc;
+   char *outFile;
+
+   getBufferStats(buffer, &total, &files);
+
+   desc.numFields = sizeof(columns) / sizeof(columns[0]);
+   for (int i = 0; i < desc.numFields; i++) {
+      strcpy(desc.fields[i].name, columns[i]);
+      desc.fields[i].type = INT;
+      desc.fields[i].size = 4;
+   }
+   desc.fields[0].type = VARCHAR;
+   desc.fields[0].size = NAME_LEN;
+   desc.fields[5].type = FLOAT;
+   desc.fields[5].size = 8;
+
+   int fd = makeTempTable(buffer, &outFile, desc);
+   HeapWriter out(buffer, outFile);
+   insertBufferStats(out, desc, "*", &total);
+   for (auto fIter = files.begin(); fIter != files.end(); fIter++) {
+      string name = fIter->first == DROPPED_FILES ? "(dropped)"
+       : getFileName(fIter->first);
+      insertBufferStats(out, desc, name.empty() ? to_string(fIter->first) : name,
+       &fIter->second);
+   }
+   if (out.flush() < 0)
+      fprintf(stderr, "could not write all of the buffer stats\n");
+   return fd;
+}
+
+/*
+ * Grows or shrinks the buffer pool. It can't go past FLOPPY_BUF_MAX_BLOCKS,
+ * the size the pool was set up for, or drop frames that are pinned.
+ */
+void setBufferSizeStatement(FLOPPYSetBufferSizeStatement *stm) {
+   if (resizeBuffer(buffer, stm->nBlocks) == -1) {
+      printf("Could not resize buffer to %d blocks. It takes %d to %d blocks, "
+       "and the pages it drops must be unpinned and written back.\n",
+       stm->nBlocks, buffer->nPartitions, buffer->maxBufferBlocks);
+      return;
+   }
+   printf("Buffer resized.\n");
+}
+
 int runStatement(char *query, bool *shouldDelete) {
    FLOPPYOutput *result = FLOPPYParser::parseFLOPPYString(query);
 
@@ -848,6 +936,12 @@ int runStatement(char *query, bool *shouldDelete) {
             break;
          case SelectStatement:
             return selectStatement((FLOPPYSelectStatement *) stm, shouldDelete);
+         case ShowBufferStatsStatement:
+            *shouldDelete = true;
+            return showBufferStatsStatement((FLOPPYShowBufferStatsStatement *) stm);
+         case SetBufferSizeStatement:
+            setBufferSizeStatement((FLOPPYSetBufferSizeStatement *) stm);
+            break;
          default:
             printf("what\n");
       }
@@ -860,10 +954,55 @@ int runStatement(char *query, bool *shouldDelete) {
    return 0;
 }
 
+/* returns the integer in environment variable name, or def if it isn't set */
+static int envInt(const char *name, int def) {
+   char *value = getenv(name);
+   return value ? atoi(value) : def;
+}
+
 int main() {
    buffer = (Buffer *)malloc(sizeof(Buffer));
 
-   commence((char *)"db.dsk", buffer, BUF_BLOCKS, CACHE_BLOCKS);
+   /* FLOPPY_BUF_BLOCKS and FLOPPY_CACHE_BLOCKS size the pool,
+    * FLOPPY_BUF_MAX_BLOCKS is how far SET BUFFER SIZE may grow it and
+    * FLOPPY_HUGE_PAGES=0|1|2 backs it with small, transparent huge or
+    * explicit huge pages */
+   int nBlocks = envInt("FLOPPY_BUF_BLOCKS", BUF_BLOCKS);
+   /* FLOPPY_DIRECT_IO=1 keeps table pages out of the kernel page cache, so
+    * the buffer pool is the only cache they are in */
+   tfs_setDirectIO(envInt("FLOPPY_DIRECT_IO", 0));
+   /* FLOPPY_PAGE_SIZE=<bytes> is the page size of a database made now, one
+    * that exists keeps its own */
+   if (tfs_setPageSize(envInt("FLOPPY_PAGE_SIZE", DEFAULT_BLOCKSIZE)) < 0) {
+      fprintf(stderr, "FLOPPY_PAGE_SIZE must be %d, 4096, 8192, 16384 or 32768\n",
+       DEFAULT_BLOCKSIZE);
+      return 1;
+   }
+   if (commenceArena((char *)"db.dsk", buffer, nBlocks,
+    envInt("FLOPPY_CACHE_BLOCKS", CACHE_BLOCKS),
+    envInt("FLOPPY_BUF_MAX_BLOCKS", nBlocks),
+    (ArenaPages)envInt("FLOPPY_HUGE_PAGES", ARENA_HUGE_PAGES)) < 0) {
+      fprintf(stderr, "could not set up the buffer pool\n");
+      return 1;
+   }
+   openHeapFiles(buffer);
+
+   /* FLOPPY_MMAP=1 reads and writes table pages in place in mappings of
+    * their files instead of through the buffer pool */
+   setMmapMode(buffer, envInt("FLOPPY_MMAP", 0));
+
+   /* FLOPPY_WARM=1 reloads the pages db.dsk.warm lists and saves the pool
+    * there again on exit */
+   if (envInt("FLOPPY_WARM", 0))
+      startWarmer(buffer);
+
+   /* FLOPPY_TRACE=<file> records every page request for bufferSim */
+   if (getenv("FLOPPY_TRACE") && startTrace(buffer, getenv("FLOPPY_TRACE")) < 0)
+      perror("FLOPPY_TRACE");
+
+   /* FLOPPY_DIRTY_TARGET=<percent> turns on the background writer */
+   if (getenv("FLOPPY_DIRTY_TARGET"))
+      startBgWriter(buffer, atoi(getenv("FLOPPY_DIRTY_TARGET")));
 
    //Server server(PORT_NUM);
 
@@ -892,13 +1031,10 @@ int main() {
          deleteFile(buffer, fd);
    }
 
-   for (auto fIter = volatileFds.begin(); fIter != volatileFds.end(); fIter++) {
-      TupleIterator iter(*fIter);
-
-      for (Record *record = iter.next(); record; record = iter.next()) {
-         deleteRecord(buffer, record->page, record->ndx);
-      }
-   }
+   // volatile tables only ever lived in memory, drop their empty files
+   for (auto fIter = volatileFds.begin(); fIter != volatileFds.end(); fIter++)
+      deleteFile(buffer, *fIter);
+   closeHeapFiles(buffer);
    squash(buffer);
 
    return 0;
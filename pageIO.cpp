@@ -0,0 +1,311 @@
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include "pageIO.h"
+
+static int uringSetup(unsigned entries, struct io_uring_params *p) {
+   return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int uringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+   return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, NULL, 0);
+}
+
+/* sets up io->ring, returns -1 if the kernel won't give us an io_uring */
+static int openRing(PageIO *io) {
+   PageIORing *r = &io->ring;
+   struct io_uring_params p;
+
+   memset(&p, 0, sizeof(p));
+   r->fd = uringSetup(PAGEIO_DEPTH, &p);
+   if (r->fd < 0)
+      return -1;
+
+   r->sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+   r->cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+   if (p.features & IORING_FEAT_SINGLE_MMAP) {
+      if (r->cqRingSize > r->sqRingSize)
+         r->sqRingSize = r->cqRingSize;
+      r->cqRingSize = r->sqRingSize;
+   }
+   r->sqRing = mmap(NULL, r->sqRingSize, PROT_READ | PROT_WRITE,
+    MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQ_RING);
+   if (r->sqRing == MAP_FAILED) {
+      close(r->fd);
+      return -1;
+   }
+   if (p.features & IORING_FEAT_SINGLE_MMAP) {
+      r->cqRing = r->sqRing;
+   }
+   else {
+      r->cqRing = mmap(NULL, r->cqRingSize, PROT_READ | PROT_WRITE,
+       MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_CQ_RING);
+      if (r->cqRing == MAP_FAILED) {
+         munmap(r->sqRing, r->sqRingSize);
+         close(r->fd);
+         return -1;
+      }
+   }
+   r->sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+   r->sqes = (struct io_uring_sqe *)mmap(NULL, r->sqesSize, PROT_READ | PROT_WRITE,
+    MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQES);
+   if (r->sqes == MAP_FAILED) {
+      if (r->cqRing != r->sqRing)
+         munmap(r->cqRing, r->cqRingSize);
+      munmap(r->sqRing, r->sqRingSize);
+      close(r->fd);
+      return -1;
+   }
+
+   char *sq = (char *)r->sqRing, *cq = (char *)r->cqRing;
+   r->sqHead = (unsigned *)(sq + p.sq_off.head);
+   r->sqTail = (unsigned *)(sq + p.sq_off.tail);
+   r->sqMask = (unsigned *)(sq + p.sq_off.ring_mask);
+   r->sqArray = (unsigned *)(sq + p.sq_off.array);
+   r->cqHead = (unsigned *)(cq + p.cq_off.head);
+   r->cqTail = (unsigned *)(cq + p.cq_off.tail);
+   r->cqMask = (unsigned *)(cq + p.cq_off.ring_mask);
+   r->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+   return 0;
+}
+
+static void closeRing(PageIO *io) {
+   PageIORing *r = &io->ring;
+   munmap(r->sqes, r->sqesSize);
+   if (r->cqRing != r->sqRing)
+      munmap(r->cqRing, r->cqRingSize);
+   munmap(r->sqRing, r->sqRingSize);
+   close(r->fd);
+}
+
+/* emulated backend: each worker does one request at a time */
+static void workerLoop(PageIO *io) {
+   std::unique_lock<std::mutex> lock(io->lock);
+   while (1) {
+      while (!io->stop && io->queue.empty())
+         io->work.wait(lock);
+      if (io->queue.empty())
+         break;
+      PageIORequest *req = io->queue.front();
+      io->queue.pop_front();
+      lock.unlock();
+
+      off_t offset = (off_t)req->page * BLOCKSIZE;
+      ssize_t n = req->op == PAGEIO_READ ? preadv(req->FD, req->iov, req->count, offset)
+       : pwritev(req->FD, req->iov, req->count, offset);
+
+      lock.lock();
+      req->result = n < 0 ? -errno : (int)n;
+      req->done = 1;
+      io->inFlight--;
+      io->completed.notify_all();
+   }
+}
+
+/*
+ * Returns a new PageIO. Asking for PAGEIO_URING gets the emulated backend
+ * when the kernel has no io_uring or doesn't let us use it.
+ */
+PageIO *pageIOCreate(PageIOBackend backend) {
+   PageIO *io = new PageIO;
+   io->inFlight = 0;
+   io->reaping = 0;
+   io->stop = 0;
+
+   if (backend == PAGEIO_URING && openRing(io) < 0)
+      backend = PAGEIO_EMULATED;
+   io->backend = backend;
+
+   if (backend == PAGEIO_EMULATED) {
+      for (int i = 0; i < PAGEIO_THREADS; i++)
+         io->workers.push_back(std::thread(workerLoop, io));
+   }
+   return io;
+}
+
+/* Frees io. Requests still in flight must be waited for first. */
+void pageIODestroy(PageIO *io) {
+   if (!io)
+      return;
+   if (io->backend == PAGEIO_URING) {
+      closeRing(io);
+   }
+   else {
+      {
+         std::lock_guard<std::mutex> lock(io->lock);
+         io->stop = 1;
+         io->work.notify_all();
+      }
+      for (size_t i = 0; i < io->workers.size(); i++)
+         io->workers[i].join();
+   }
+   delete io;
+}
+
+/* fills in req, see PageIORequest */
+void pageIOPrepare(PageIORequest *req, PageIOOp op, fileDescriptor FD,
+ unsigned int page, unsigned char **data, int count) {
+   req->op = op;
+   req->FD = FD;
+   req->page = page;
+   req->data = data;
+   req->count = count;
+   req->result = 0;
+   req->done = 0;
+   for (int i = 0; i < count; i++) {
+      req->iov[i].iov_base = data[i];
+      req->iov[i].iov_len = BLOCKSIZE;
+   }
+}
+
+/* hands the SQEs queued since the last call to the kernel */
+static void flushRing(PageIO *io, unsigned *pending) {
+   while (*pending) {
+      int n = uringEnter(io->ring.fd, *pending, 0, 0);
+      if (n < 0) {
+         if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+            continue;
+         perror("pageIO, io_uring_enter");
+         return;
+      }
+      *pending -= n;
+   }
+}
+
+/*
+ * Waits until some request completes. Called with io->lock held through
+ * lock. With io_uring one thread at a time waits on the ring and marks
+ * what it finds done, the others wait for it to finish.
+ */
+static void waitCompletion(PageIO *io, std::unique_lock<std::mutex> &lock) {
+   PageIORing *r = &io->ring;
+
+   if (io->backend == PAGEIO_EMULATED || io->reaping) {
+      io->completed.wait(lock);
+      return;
+   }
+
+   io->reaping = 1;
+   lock.unlock();
+   if (__atomic_load_n(r->cqHead, __ATOMIC_RELAXED) == __atomic_load_n(r->cqTail, __ATOMIC_ACQUIRE))
+      uringEnter(r->fd, 0, 1, IORING_ENTER_GETEVENTS);
+   lock.lock();
+
+   unsigned head = *r->cqHead;
+   while (head != __atomic_load_n(r->cqTail, __ATOMIC_ACQUIRE)) {
+      struct io_uring_cqe *cqe = &r->cqes[head & *r->cqMask];
+      PageIORequest *req = (PageIORequest *)(uintptr_t)cqe->user_data;
+      req->result = cqe->res;
+      req->done = 1;
+      io->inFlight--;
+      head++;
+   }
+   __atomic_store_n(r->cqHead, head, __ATOMIC_RELEASE);
+   io->reaping = 0;
+   io->completed.notify_all();
+}
+
+/*
+ * Starts the n requests, waiting for room when PAGEIO_DEPTH are already in
+ * flight. Returns without waiting for them to finish, see pageIOWait.
+ */
+int pageIOSubmit(PageIO *io, PageIORequest **reqs, int n) {
+   PageIORing *r = &io->ring;
+   std::unique_lock<std::mutex> lock(io->lock);
+   unsigned pending = 0;
+
+   for (int i = 0; i < n; i++) {
+      PageIORequest *req = reqs[i];
+      while (io->inFlight == PAGEIO_DEPTH) {
+         flushRing(io, &pending);
+         waitCompletion(io, lock);
+      }
+      io->inFlight++;
+
+      if (io->backend == PAGEIO_EMULATED) {
+         io->queue.push_back(req);
+         io->work.notify_one();
+         continue;
+      }
+
+      unsigned tail = *r->sqTail, slot = tail & *r->sqMask;
+      struct io_uring_sqe *sqe = &r->sqes[slot];
+      memset(sqe, 0, sizeof(*sqe));
+      sqe->opcode = req->op == PAGEIO_READ ? IORING_OP_READV : IORING_OP_WRITEV;
+      sqe->fd = req->FD;
+      sqe->addr = (unsigned long)req->iov;
+      sqe->len = req->count;
+      sqe->off = (unsigned long long)req->page * BLOCKSIZE;
+      sqe->user_data = (unsigned long long)(uintptr_t)req;
+      r->sqArray[slot] = slot;
+      __atomic_store_n(r->sqTail, tail + 1, __ATOMIC_RELEASE);
+      pending++;
+   }
+   flushRing(io, &pending);
+   return n;
+}
+
+/*
+ * Called on a read that came back short. Returns 1 if it stopped at the end
+ * of the file, after zeroing what of the pages lies past it, or 0 if the
+ * file goes on and the read has to be done again.
+ */
+static int readToEnd(PageIORequest *req) {
+   struct stat st;
+   off_t end = (off_t)req->page * BLOCKSIZE + req->result;
+   if (fstat(req->FD, &st) < 0 || end < st.st_size)
+      return 0;
+   for (int i = 0; i < req->count; i++) {
+      long got = req->result - (long)i * BLOCKSIZE;
+      if (got < 0)
+         got = 0;
+      if (got < BLOCKSIZE)
+         memset(req->data[i] + got, 0, BLOCKSIZE - got);
+   }
+   return 1;
+}
+
+/*
+ * Waits for the n requests, which must have been submitted to io. A request
+ * the backend failed on (a file that turned out not to take direct I/O, say)
+ * is done again through the synchronous tfs_ calls, and so is a read that
+ * came back short before the end of the file. Returns how many had to be,
+ * or -1 if any of those failed too.
+ */
+int pageIOWait(PageIO *io, PageIORequest **reqs, int n) {
+   int i, redone = 0, failed = 0;
+   {
+      std::unique_lock<std::mutex> lock(io->lock);
+      for (i = 0; i < n; i++) {
+         while (!reqs[i]->done)
+            waitCompletion(io, lock);
+      }
+   }
+
+   for (i = 0; i < n; i++) {
+      PageIORequest *req = reqs[i];
+      if (req->result == req->count * BLOCKSIZE)
+         continue;
+      /* pages past the end of the file read as zeros */
+      if (req->op == PAGEIO_READ && req->result >= 0 && readToEnd(req))
+         continue;
+      if ((req->op == PAGEIO_READ ? tfs_readPages(req->FD, req->page, req->data, req->count)
+       : tfs_writePages(req->FD, req->page, req->data, req->count)) < 0)
+         failed = 1;
+      redone++;
+   }
+   return failed ? -1 : redone;
+}
+
+/* pageIOSubmit followed by pageIOWait */
+int pageIORun(PageIO *io, PageIORequest **reqs, int n) {
+   pageIOSubmit(io, reqs, n);
+   return pageIOWait(io, reqs, n);
+}
@@ -0,0 +1,76 @@
+#ifndef PAGEIO_H
+#define PAGEIO_H
+
+#include <sys/uio.h>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include "tinyFS.h"
+#include "libTinyFS.h"
+
+/* most requests a PageIO keeps in flight, and most pages in one request */
+#define PAGEIO_DEPTH 64
+#define PAGEIO_MAX_PAGES 64
+
+/* worker threads of the emulated backend */
+#define PAGEIO_THREADS 4
+
+enum PageIOBackend { PAGEIO_URING, PAGEIO_EMULATED };
+enum PageIOOp { PAGEIO_READ, PAGEIO_WRITE };
+
+/*
+ * One read or write of count consecutive pages of a file, starting at page,
+ * with data[i] holding page + i. The request belongs to the backend from
+ * pageIOSubmit until pageIOWait returns it.
+ */
+typedef struct {
+   PageIOOp op;
+   fileDescriptor FD;
+   unsigned int page;
+   unsigned char **data;
+   int count;
+   int result; /* bytes moved, or -errno, once done */
+   int done;
+   struct iovec iov[PAGEIO_MAX_PAGES];
+} PageIORequest;
+
+/* the io_uring rings as mapped from the kernel, see pageIOCreate() */
+typedef struct {
+   int fd;
+   unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+   unsigned *cqHead, *cqTail, *cqMask;
+   struct io_uring_sqe *sqes;
+   struct io_uring_cqe *cqes;
+   void *sqRing, *cqRing;
+   size_t sqRingSize, cqRingSize, sqesSize;
+} PageIORing;
+
+/*
+ * An asynchronous page I/O queue. Requests go to io_uring when the kernel
+ * has it and to a small pool of threads doing preadv/pwritev otherwise.
+ * Any number of threads may submit and wait on the same PageIO.
+ */
+typedef struct {
+   PageIOBackend backend;
+   std::mutex lock; /* guards everything below */
+   std::condition_variable completed; /* some request got done */
+   int inFlight;
+   int reaping; /* a thread is waiting on the ring for completions */
+   PageIORing ring;
+   std::deque<PageIORequest *> queue; /* emulated: not yet picked up */
+   std::condition_variable work;
+   std::vector<std::thread> workers;
+   int stop;
+} PageIO;
+
+PageIO *pageIOCreate(PageIOBackend backend);
+void pageIODestroy(PageIO *io);
+int pageIOSubmit(PageIO *io, PageIORequest **reqs, int n);
+int pageIOWait(PageIO *io, PageIORequest **reqs, int n);
+int pageIORun(PageIO *io, PageIORequest **reqs, int n);
+void pageIOPrepare(PageIORequest *req, PageIOOp op, fileDescriptor FD,
+ unsigned int page, unsigned char **data, int count);
+
+#endif
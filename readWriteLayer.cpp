@@ -112,11 +112,11 @@ int writeVolatile(Buffer *buf, DiskAddress page, int startOffset, int nBytes, ch
  * if the page is not found in THE BUFFER, returns null 
  */
 char *readPersistent(Buffer *buf, DiskAddress page, int startOffset, int nBytes) {
-   int index = readPage(buf, page);
+   PageGuard guard(buf, page, NULL, LATCH_SHARED);
    char *ret;
    int size = nBytes;
 
-   if (index == -1)
+   if (!guard.valid())
       return NULL;
    
    if (startOffset-1+nBytes >= BLOCKSIZE) {
@@ -124,35 +124,82 @@ char *readPersistent(Buffer *buf, DiskAddress page, int startOffset, int nBytes)
    }
    
    ret = (char *)calloc(size, sizeof(char));
-   memcpy(ret, buf->pages[index].block + startOffset, size);
+   memcpy(ret, guard.data() + startOffset, size);
    
    return ret;
 }
 
+PageSpan::PageSpan(Buffer *buf, DiskAddress page, int startOffset, int nBytes,
+ BufferRing *ring)
+ : guard(buf, page, ring, LATCH_SHARED), startOffset(startOffset), nBytes(nBytes) {
+   if (startOffset + nBytes > BLOCKSIZE)
+      this->nBytes = BLOCKSIZE - startOffset;
+}
+
+bool PageSpan::valid() {
+   return guard.valid() && startOffset >= 0 && nBytes >= 0;
+}
+
+const char *PageSpan::data() {
+   return guard.data() + startOffset;
+}
+
+int PageSpan::size() {
+   return nBytes;
+}
+
+PageEdit::PageEdit(Buffer *buf, DiskAddress page, int startOffset, int nBytes)
+ : guard(buf, page, NULL, LATCH_EXCLUSIVE), startOffset(startOffset), nBytes(nBytes) {
+   if (startOffset + nBytes > BLOCKSIZE)
+      this->nBytes = BLOCKSIZE - startOffset;
+}
+
+PageEdit::~PageEdit() {
+   if (valid())
+      guard.markDirty();
+}
+
+bool PageEdit::valid() {
+   return guard.valid() && startOffset >= 0 && nBytes >= 0;
+}
+
+char *PageEdit::data() {
+   return guard.data() + startOffset;
+}
+
+int PageEdit::size() {
+   return nBytes;
+}
+
+/* same as readPersistent, but into out. Returns the number of bytes copied,
+ * or -1 if page can't be read */
+int readInto(Buffer *buf, DiskAddress page, int startOffset, int nBytes, char *out) {
+   PageSpan span(buf, page, startOffset, nBytes);
+   if (!span.valid())
+      return -1;
+
+   memcpy(out, span.data(), span.size());
+   return span.size();
+}
+
 /* writes the first nBytes from data starting at startOffset into page at diskAddress page and returns 0 on success
  * Returns -1 if page is not located in the BUFFER
  * Returns -2 if startOffset+nBytes is greater than the page size 
  * if dataSize is less than nBytes, will write what it can and pad rest with 0's
  */
 int writePersistent(Buffer *buf, DiskAddress page, int startOffset, int nBytes, char * data, int dataSize) {
-   int index = readPage(buf, page);
    int size = nBytes;
-   char *temp;
 
-   if (index == -1)
-      return -1;
-   
    if (startOffset-1+nBytes >= BLOCKSIZE) 
       return -2;
+
+   PageEdit edit(buf, page, startOffset, nBytes);
+   if (!edit.valid())
+      return -1;
    
    if (dataSize < nBytes)
       size = dataSize;
    
-   temp = (char *)calloc(1, nBytes);
-   memcpy(temp, data, size);
-   memcpy(buf->pages[index].block + startOffset, temp, size);
-   writePage(buf, page);
-   
-   free(temp);
+   memcpy(edit.data(), data, size);
    return 0;
 }
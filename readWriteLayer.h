@@ -1,6 +1,8 @@
 #ifndef READWRITELAYER_H
 #define READWRITELAYER_H
 
+#include "bufferManager.h"
+
 char *getPage(Buffer *buf, DiskAddress page);
 
 int putPage(Buffer *buf, DiskAddress page, char *data, int dataSize);
@@ -17,4 +19,45 @@ char *readPersistent(Buffer *buf, DiskAddress page, int startOffset, int nBytes)
 
 int writePersistent(Buffer *buf, DiskAddress page, int startOffset, int nBytes, char *data, int dataSize);
 
+/* copies nBytes of page from startOffset into out instead of allocating */
+int readInto(Buffer *buf, DiskAddress page, int startOffset, int nBytes, char *out);
+
+/*
+ * nBytes of page from startOffset on, read where they are in the buffer
+ * instead of copied out. The page stays pinned and read-latched as long as
+ * the span lives, so keep it short and don't write the page meanwhile.
+ * A scan passes its ring, see readPageRing.
+ */
+class PageSpan {
+public:
+   PageSpan(Buffer *buf, DiskAddress page, int startOffset, int nBytes,
+    BufferRing *ring = NULL);
+   bool valid();
+   const char *data();
+   int size(); /* nBytes, or less if the page ends first */
+
+private:
+   PageGuard guard;
+   int startOffset;
+   int nBytes;
+};
+
+/*
+ * Like PageSpan, but write-latched and writable in place. The page is
+ * marked dirty once, when the edit goes away.
+ */
+class PageEdit {
+public:
+   PageEdit(Buffer *buf, DiskAddress page, int startOffset, int nBytes);
+   ~PageEdit();
+   bool valid();
+   char *data();
+   int size();
+
+private:
+   PageGuard guard;
+   int startOffset;
+   int nBytes;
+};
+
 #endif
\ No newline at end of file
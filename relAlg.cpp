@@ -116,26 +116,26 @@ bool checkCondition(Record *record, FLOPPYNode *cond);
 
 int selectScan(fileDescriptor inTable, FLOPPYNode *cond, fileDescriptor *outTable) {
    char *outFile;
-   DiskAddress temp;
    RecordDesc recordDesc;
 
    heapHeaderGetRecordDesc(buffer, inTable, &recordDesc);
 
    // can just reuse recordDesc for new file because output tuples have same structure
    *outTable = makeTempTable(buffer, &outFile, recordDesc);
+   HeapWriter out(buffer, outFile);
 
    TupleIterator iter(inTable); // open an iterator on input file
 
    // Iterate through all tuples, outputting those that match the given condition
    for (Record *record = iter.next(); record; record = iter.next()) {
       if (checkCondition(record, cond))
-         insertRecord(buffer, outFile, record->getBytes(recordDesc), &temp);
+         out.append(record->getBytes(recordDesc));
    }
+   return out.flush();
 }
 
 int renameTable(fileDescriptor inTable, char *alias, fileDescriptor *outTable) {
    char *outFile;
-   DiskAddress temp;
    RecordDesc oldRecordDesc, newRecordDesc;
 
    heapHeaderGetRecordDesc(buffer, inTable, &oldRecordDesc);
@@ -151,6 +151,8 @@ int renameTable(fileDescriptor inTable, char *alias, fileDescriptor *outTable) {
 
    *outTable = makeTempTable(buffer, &outFile, newRecordDesc);
 
+   HeapWriter out(buffer, outFile);
+
    TupleIterator iter(inTable); // open an iterator on input file
 
    for (Record *record = iter.next(); record; record = iter.next()) {
@@ -160,13 +162,13 @@ int renameTable(fileDescriptor inTable, char *alias, fileDescriptor *outTable) {
          string newName(newRecordDesc.fields[i].name);
          newRecord.fields[newName] = record->fields[oldName];
       }
-      insertRecord(buffer, outFile, newRecord.getBytes(newRecordDesc), &temp);
+      out.append(newRecord.getBytes(newRecordDesc));
    }
+   return out.flush();
 }
 
 int project(fileDescriptor inTable, vector<FLOPPYTableAttribute *> *attributes, fileDescriptor *outTable) {
    char *outFile;
-   DiskAddress temp;
    RecordDesc oldRecordDesc, newRecordDesc;
 
    heapHeaderGetRecordDesc(buffer, inTable, &oldRecordDesc);
@@ -204,6 +206,8 @@ int project(fileDescriptor inTable, vector<FLOPPYTableAttribute *> *attributes,
 
    *outTable = makeTempTable(buffer, &outFile, newRecordDesc);
 
+   HeapWriter out(buffer, outFile);
+
    TupleIterator iter(inTable);
 
    for (Record *record = iter.next(); record; record = iter.next()) {
@@ -228,14 +232,15 @@ int project(fileDescriptor inTable, vector<FLOPPYTableAttribute *> *attributes,
          }
       }
 
-      insertRecord(buffer, outFile, newRecord.getBytes(newRecordDesc), &temp);
+      out.append(newRecord.getBytes(newRecordDesc));
    }
+   return out.flush();
 }
 
 int product(fileDescriptor inTable1, fileDescriptor inTable2, fileDescriptor *outTable) {
    //joinNestedLoops(inTable1, inTable2, NULL, outTable);
-   joinOnePass(inTable1, inTable2, NULL, outTable);
    // TODO change back to joinNestedLoops
+   return joinOnePass(inTable1, inTable2, NULL, outTable);
 }
 
 /*appends all of record1's fields to record2*/
@@ -248,7 +253,6 @@ void combineRecords(Record *rec1, Record *rec2) {
 int joinOnePass(fileDescriptor inTable1, fileDescriptor inTable2,
                 FLOPPYNode *condition, fileDescriptor *outTable) {
    char *outFile;
-   DiskAddress temp;
    RecordDesc oldRecordDesc1, oldRecordDesc2, newRecordDesc;
    int numBlocksT1, numBlocksT2, i, j;
 
@@ -274,6 +278,8 @@ int joinOnePass(fileDescriptor inTable1, fileDescriptor inTable2,
    }
    
    *outTable = makeTempTable(buffer, &outFile, newRecordDesc);
+   
+   HeapWriter out(buffer, outFile);
 
    TupleIterator iter1(inTable1);
       
@@ -284,20 +290,21 @@ int joinOnePass(fileDescriptor inTable1, fileDescriptor inTable2,
          combineRecords(record1, record2);
             
          if (checkCondition(record2, condition))
-            insertRecord(buffer, outFile, record2->getBytes(newRecordDesc), &temp); 
+            out.append(record2->getBytes(newRecordDesc));
       }      
    }   
+   return out.flush();
 }
 
 int joinMultiPass(fileDescriptor inTable1, fileDescriptor inTable2,
                   FLOPPYNode *condition, fileDescriptor *outTable) {
    // TODO
+   return 0;
 }
 
 int joinNestedLoops(fileDescriptor inTable1, fileDescriptor inTable2,
                     FLOPPYNode *condition, fileDescriptor *outTable) {
    char *outFile;
-   DiskAddress temp;
    RecordDesc oldRecordDesc1, oldRecordDesc2, newRecordDesc;
    int numBlocksT1, numBlocksT2, i, j;
 
@@ -325,7 +332,7 @@ int joinNestedLoops(fileDescriptor inTable1, fileDescriptor inTable2,
    //}
    
    *outTable = makeTempTable(buffer, &outFile, newRecordDesc);
-
+   
    TupleIterator iter1(inTable1);
    TupleIterator iter2(inTable2);
 
@@ -333,6 +340,7 @@ int joinNestedLoops(fileDescriptor inTable1, fileDescriptor inTable2,
    // for each group of (M - 1) blocks of table 2:
    //    for each tuple in table 1:
    //       join with each tuple in the current group of (M - 1) blocks
+   return 0;
 }
 
 static vector<AggResult> initAggResults(vector<Aggregate> *aggregates,
@@ -430,7 +438,6 @@ static void addAggsToRecord(Record &record, vector<AggResult> &aggResults,
 int groupOnePass(fileDescriptor inTable, vector<FLOPPYTableAttribute *> *group,
                  vector<Aggregate> *aggregates, fileDescriptor *outTable) {
    char *outFile;
-   DiskAddress temp;
    RecordDesc oldRecordDesc, newRecordDesc;
 
    heapHeaderGetRecordDesc(buffer, inTable, &oldRecordDesc);
@@ -484,6 +491,8 @@ int groupOnePass(fileDescriptor inTable, vector<FLOPPYTableAttribute *> *group,
 
    *outTable = makeTempTable(buffer, &outFile, newRecordDesc);
 
+   HeapWriter out(buffer, outFile);
+
    TupleIterator iter(inTable); // open an iterator on input file
 
    if (!group) {
@@ -495,7 +504,7 @@ int groupOnePass(fileDescriptor inTable, vector<FLOPPYTableAttribute *> *group,
       Record record;
       addAggsToRecord(record, aggResults, aggregates, newRecordDesc);
 
-      insertRecord(buffer, outFile, record.getBytes(newRecordDesc), &temp);
+      out.append(record.getBytes(newRecordDesc));
    }
    else {
       map<vector<RecordField>, vector<AggResult>> groups;
@@ -528,14 +537,16 @@ int groupOnePass(fileDescriptor inTable, vector<FLOPPYTableAttribute *> *group,
 
          addAggsToRecord(record, gIter->second, aggregates, newRecordDesc);
 
-         insertRecord(buffer, outFile, record.getBytes(newRecordDesc), &temp);
+         out.append(record.getBytes(newRecordDesc));
       }
    }
+   return out.flush();
 }
 
 int groupMultiPass(fileDescriptor inTable, vector<FLOPPYTableAttribute *> *group,
                    vector<Aggregate> *aggregates, fileDescriptor *outTable) {
    // TODO
+   return 0;
 }
 
 class RecordSorter {
@@ -559,13 +570,14 @@ private:
 int duplicateElimination(fileDescriptor inTable, vector<FLOPPYTableAttribute *> *attributes,
                          fileDescriptor *outTable) {
    char *outFile;
-   DiskAddress temp;
    RecordDesc recordDesc;
 
    heapHeaderGetRecordDesc(buffer, inTable, &recordDesc);
 
    *outTable = makeTempTable(buffer, &outFile, recordDesc);
 
+   HeapWriter out(buffer, outFile);
+
    vector<Record *> records;
    TupleIterator iter(inTable);
 
@@ -605,20 +617,22 @@ int duplicateElimination(fileDescriptor inTable, vector<FLOPPYTableAttribute *>
             continue;
       }
 
-      insertRecord(buffer, outFile, records[i]->getBytes(recordDesc), &temp);
+      out.append(records[i]->getBytes(recordDesc));
       prev = records[i];
    }
+   return out.flush();
 }
 
 int sortTable(fileDescriptor inTable, vector<FLOPPYTableAttribute *> *attributes, fileDescriptor *outTable) {
    char *outFile;
-   DiskAddress temp;
    RecordDesc recordDesc;
 
    heapHeaderGetRecordDesc(buffer, inTable, &recordDesc);
 
    *outTable = makeTempTable(buffer, &outFile, recordDesc);
 
+   HeapWriter out(buffer, outFile);
+
    vector<Record *> records;
    TupleIterator iter(inTable);
 
@@ -639,22 +653,25 @@ int sortTable(fileDescriptor inTable, vector<FLOPPYTableAttribute *> *attributes
    sort(records.begin(), records.end(), RecordSorter(sortAttributes, recordDesc));
 
    for (int i = 0; i < records.size(); i++)
-      insertRecord(buffer, outFile, records[i]->getBytes(recordDesc), &temp);
+      out.append(records[i]->getBytes(recordDesc));
+   return out.flush();
 }
 
 int limitTable(fileDescriptor inTable, int k, fileDescriptor *outTable) {
    char *outFile;
-   DiskAddress temp;
    RecordDesc recordDesc;
 
    heapHeaderGetRecordDesc(buffer, inTable, &recordDesc);
 
    *outTable = makeTempTable(buffer, &outFile, recordDesc);
 
+   HeapWriter out(buffer, outFile);
+
    TupleIterator iter(inTable);
 
    for (Record *record = iter.next(); record && k; record = iter.next(), k--)
-      insertRecord(buffer, outFile, record->getBytes(recordDesc), &temp);
+      out.append(record->getBytes(recordDesc));
+   return out.flush();
 }
 
 
@@ -43,6 +43,8 @@ int sortTable(fileDescriptor inTable, vector<FLOPPYTableAttribute *> *attributes
 
 int limitTable(fileDescriptor inTable, int k, fileDescriptor *outTable);
 
+fileDescriptor makeTempTable(Buffer *buf, char **filename, RecordDesc recordDesc);
+
 
 RecordField evalExpr(Record *record, FLOPPYNode *expr);
 bool checkCondition(Record *record, FLOPPYNode *cond);
@@ -23,7 +23,11 @@ SequentialFileHeader *getSequentialFileHeader(Buffer *buf, fileDescriptor fd) {
        allocateCachePage(buf, addr);
    }
    
-   return (SequentialFileHeader *)read(buf, addr, 0, sizeof(SequentialFileHeader));
+   if (readInto(buf, addr, 0, sizeof(SequentialFileHeader), (char *)header) < 0) {
+      free(header);
+      return NULL;
+   }
+   return header;
 }
 
 int pHIncrementRecords(Buffer *buf, DiskAddress page) {
@@ -92,25 +96,7 @@ int createSequentialFile(Buffer *buf, char *createTable, RecordDesc recordDesc,
 //Once volatile and persistent list functions are finished, update this function
 int deleteSequentialFile(Buffer *buf, char *tableName) {
    int fd = tfs_openFile(tableName);
-   tfs_deleteFile(fd);
-   
-   int i;
-   for (i = 0; i < buf->nBufferBlocks; i++) {
-      if (buf->buffer_timestamp[i] == -1)
-         continue;
-      if (buf->pages[i].address.FD == fd) {
-         buf->buffer_timestamp[i] = -1;
-         buf->numBufferOccupied--;
-      }
-   }
-   for (i = 0; i < buf->nCacheBlocks; i++) {
-      if (buf->cache_timestamp[i] == -1)
-         continue;
-      if (buf->cache[i].address.FD == fd) {
-         buf->cache_timestamp[i] = -1;
-         buf->numCacheOccupied--;
-      }
-   }
+   deleteFile(buf, fd);
    
    //if(checkPersistentFiles(buf, fd) >= 0) {
    //    removeFileFromPersistentList(buf, fd);
@@ -151,9 +137,8 @@ int seqGetRecord(Buffer *buf, DiskAddress page, int recordId, char *bytes) {
    else
       allocateCachePage(buf, page);
 
-   char *record = read(buf, page,
-   sizeof(SequentialFileHeader) + recordId * recordSize, recordSize);
-   memcpy(bytes, record, recordSize);
+   if (readInto(buf, page, sizeof(SequentialFileHeader) + recordId * recordSize, recordSize, bytes) < 0)
+      return -1;
    return 0;
 }
 
@@ -205,7 +190,7 @@ int seqPutRecord(Buffer *buf, DiskAddress page, char *bytes) {
         memcpy(&insertInt, bytes + offset, attSize);
         
         for(i = 0; i < numRecords; i++) {
-            memcpy(curRecord, read(buf, page, offset + PAGE_HDR_SIZE + (i * recordSize), attSize), attSize);
+            readInto(buf, page, offset + PAGE_HDR_SIZE + (i * recordSize), attSize, curRecord);
             memcpy(&curInt, curRecord, attSize);
             if(curInt > insertInt) {
                 break;
@@ -216,7 +201,7 @@ int seqPutRecord(Buffer *buf, DiskAddress page, char *bytes) {
         memcpy(&curFloat, curRecord, attSize);
         
         for(i = 0; i < numRecords; i++) {
-            memcpy(curRecord, read(buf, page, offset + PAGE_HDR_SIZE + (i * recordSize), attSize), attSize);
+            readInto(buf, page, offset + PAGE_HDR_SIZE + (i * recordSize), attSize, curRecord);
             memcpy(&curFloat, curRecord, attSize);
             if(curInt > insertInt) {
                 break;
@@ -227,7 +212,7 @@ int seqPutRecord(Buffer *buf, DiskAddress page, char *bytes) {
         curVarchar = curRecord;
         
         for(i = 0; i < numRecords; i++) {
-            memcpy(curRecord, read(buf, page, offset + PAGE_HDR_SIZE + (i * recordSize), attSize), attSize);
+            readInto(buf, page, offset + PAGE_HDR_SIZE + (i * recordSize), attSize, curRecord);
             memcpy(&curVarchar, curRecord, attSize);
             if(curInt > insertInt) {
                 break;
@@ -238,7 +223,7 @@ int seqPutRecord(Buffer *buf, DiskAddress page, char *bytes) {
         memcpy(&curInt, curRecord, attSize);
         
         for(i = 0; i < numRecords; i++) {
-            memcpy(curRecord, read(buf, page, offset + PAGE_HDR_SIZE + (i * recordSize), attSize), attSize);
+            readInto(buf, page, offset + PAGE_HDR_SIZE + (i * recordSize), attSize, curRecord);
             memcpy(&curInt, curRecord, attSize);
             if(curInt > insertInt) {
                 break;
@@ -249,7 +234,7 @@ int seqPutRecord(Buffer *buf, DiskAddress page, char *bytes) {
         memcpy(&curInt, curRecord, attSize);
         
         for(i = 0; i < numRecords; i++) {
-            memcpy(curRecord, read(buf, page, offset + PAGE_HDR_SIZE + (i * recordSize), attSize), attSize);
+            readInto(buf, page, offset + PAGE_HDR_SIZE + (i * recordSize), attSize, curRecord);
             memcpy(&curInt, curRecord, attSize);
             if(curInt > insertInt) {
                 break;
@@ -294,11 +279,11 @@ int shiftRecordsTowardsfront(Buffer *buf, DiskAddress page, int shiftIndex) {
     if(numRecords == 0)
         return -1;
 
-    memcpy(nextRecord, read(buf, page, PAGE_HDR_SIZE + ((numRecords - 1) * recordSize), recordSize), recordSize);
+    readInto(buf, page, PAGE_HDR_SIZE + ((numRecords - 1) * recordSize), recordSize, nextRecord);
     
     for(i = numRecords - 1; i > shiftIndex; i--) {
         memcpy(curRecord, nextRecord, recordSize);
-        memcpy(nextRecord, read(buf, page, PAGE_HDR_SIZE + ((i - 1) * recordSize), recordSize), recordSize);
+        readInto(buf, page, PAGE_HDR_SIZE + ((i - 1) * recordSize), recordSize, nextRecord);
         write(buf, page, PAGE_HDR_SIZE + (i - 1) * recordSize, recordSize, curRecord, recordSize);
     }    
     return 0;
@@ -318,11 +303,11 @@ int shiftRecordsTowardsEnd(Buffer *buf, DiskAddress page, int shiftIndex) {
     pHGetNumRecords(buf, page, &numRecords);
 
 
-    memcpy(nextRecord, read(buf, page, PAGE_HDR_SIZE + (shiftIndex * recordSize), recordSize), recordSize);
+    readInto(buf, page, PAGE_HDR_SIZE + (shiftIndex * recordSize), recordSize, nextRecord);
     
     for(i = shiftIndex; i < numRecords; i++) {
         memcpy(curRecord, nextRecord, recordSize);
-        memcpy(nextRecord, read(buf, page, PAGE_HDR_SIZE + ((i + 1) * recordSize), recordSize), recordSize);
+        readInto(buf, page, PAGE_HDR_SIZE + ((i + 1) * recordSize), recordSize, nextRecord);
         write(buf, page, PAGE_HDR_SIZE + (i + 1) * recordSize, recordSize, curRecord, recordSize);
     }
     
@@ -1,5 +1,10 @@
-/* The default size of the disk and file system block */
-#define BLOCKSIZE 2048
+/* The size of the disk and file system block. Each file system picks its
+ * own when it is made, see tfs_setPageSize, and BLOCKSIZE is the one of the
+ * file system mounted. */
+extern int tfs_blockSize;
+#define BLOCKSIZE tfs_blockSize
+#define DEFAULT_BLOCKSIZE 2048
+#define MAX_BLOCKSIZE 32768
 
 #define MAX_FILES 256
 